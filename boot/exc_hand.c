@@ -2,10 +2,16 @@
 #include <printf.h>
 #include <types.h>
 #include <mmu.h>
+#include <trap.h>
+#include <fpu.h>
 
-void exc_handler(u_int64_t cause, u_int64_t badvaddr, u_int64_t epc)
+void exc_handler(struct Trapframe *tf)
 {
+	/* first FP instruction since a switch: load this env's FP state */
+	if (tf->cause == T_ILLINST && fpu_trap(tf)) {
+		return;
+	}
 	printf("Exception!!!\n");
-	printf("Cause:%ld, Bad vaddr:0x%lx, epc:0x%lx!!!\n", cause, badvaddr, epc);
+	printf("Cause:%ld, Bad vaddr:0x%lx, epc:0x%lx!!!\n", tf->cause, tf->tval, tf->epc);
 	panic("Exception!!!!!!!!!!!!!");
 }
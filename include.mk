@@ -11,4 +11,10 @@ CROSS_COMPILE := riscv64-unknown-elf-
 CC                        := $(CROSS_COMPILE)gcc
 CFLAGS            := -O -g  -fno-builtin -Wall -fPIC 
 CFLAGS            += -mcmodel=medany 
+ifdef BENCH
+CFLAGS            += -DIPC_BENCH
+endif
+ifdef DEBUG
+CFLAGS            += -DKDEBUG
+endif
 LD                        := $(CROSS_COMPILE)ld
@@ -0,0 +1,36 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _CONS_H_
+#define _CONS_H_
+
+#include <env.h>
+#include <plic.h>
+
+/* 16550 UART of QEMU virt, mapped at KDEV right after the PLIC. */
+#define UART0_PA	0x10000000
+#define UART0		(KDEV + PLIC_SIZE)
+#define UART0_IRQ	10
+
+#define UART_RBR	0	// receive buffer (read)
+#define UART_THR	0	// transmit holding (write)
+#define UART_IER	1	// interrupt enable
+#define UART_FCR	2	// FIFO control (write)
+#define UART_LSR	5	// line status
+#define UART_IER_RX	0x01	// interrupt when data is received
+#define UART_FCR_FIFO	0x07	// enable and clear both FIFOs
+#define UART_LSR_DR	0x01	// a received byte is waiting
+#define UART_LSR_THRE	0x20	// transmit holding register empty
+
+#define CONS_RXSIZE	256	// bytes buffered before input is dropped
+#define CONS_TXSIZE	1024	// bytes of output gathered per flush
+
+void cons_init(void);
+int cons_getc(void);
+void cons_wait(struct Env *e);
+int cons_intr(void);
+void cons_exit(struct Env *e);
+void cons_putc(int c);
+void cons_write(const char *s, u_int n);
+void cons_flush(void);
+
+#endif /* _CONS_H_ */
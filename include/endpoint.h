@@ -0,0 +1,30 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _ENDPOINT_H_
+#define _ENDPOINT_H_
+
+#include <env.h>
+
+#define NENDPOINT	16
+#define EPX(id)		((id) & (NENDPOINT - 1))
+
+// An IPC endpoint: calls made to it go to whichever bound server env
+// is idle, so one service can be spread over several worker envs.
+struct Endpoint {
+    u_int ep_id;			// 0 while free
+    u_int ep_owner;			// envid that allocated it
+    struct Env_tailq ep_receivers;	// bound envs idle in a receive
+    struct Env_tailq ep_senders;	// callers waiting for a receiver
+};
+
+int ep_alloc(struct Env *owner, u_int *id);
+int ep_lookup(u_int id, struct Endpoint **ep);
+int ep_bind(struct Env *caller, struct Env *e, u_int id);
+void ep_queue_sender(struct Env *e, struct Endpoint *ep, u_int value,
+                     u_int srcva, u_int perm);
+struct Env *ep_take_sender(struct Env *to);
+void ep_wait(struct Env *e);
+void ep_unwait(struct Env *e);
+void ep_exit(struct Env *e);
+
+#endif /* _ENDPOINT_H_ */
@@ -7,6 +7,7 @@
 #include "queue.h"
 #include "trap.h"
 #include "mmu.h" 
+#include "unistd.h"
 
 #define LOG2NENV	10
 #define NENV		(1<<LOG2NENV)
@@ -18,15 +19,54 @@
 #define ENV_RUNNABLE		1
 #define ENV_NOT_RUNNABLE	2
 
+// Words in an IPC register message (env_ipc_mr)
+#define IPC_MR_WORDS	8
+
+// Page grants: npages argument of sys_ipc_send_pages that makes the
+// grant a scatter list, one IPC_SEG word per range in the register
+// message words. Ranges are mapped back to back at the receiver.
+#define IPC_PAGES_SG	0x80000000
+#define IPC_SEG(va, n)	(((va) & ~(BY2PG - 1)) | (n))	// n < BY2PG pages
+#define IPC_SEG_VA(w)	((w) & ~(BY2PG - 1))
+#define IPC_SEG_N(w)	((w) & (BY2PG - 1))
+
+// sys_notif_wait return for a notification; 0 means an IPC message
+#define NOTIF_WOKEN	1
+
+// Values of env_sched_class in struct Env
+#define SCHED_FAIR	0	// weighted fair share on virtual runtime (default)
+#define SCHED_RR	1	// env_pri consecutive slices on alternating lists
+#define SCHED_EDF	2	// earliest deadline first, runtime/period reserved
+
+// Per-env page the kernel keeps current and maps read-only at UKDATA,
+// so user code can read these without a syscall. Fields after kd_seq
+// that change are written with kd_seq odd; see kdata_read() in libos.c.
+struct Kdata {
+	volatile u_int kd_seq;		// bumped before and after each update
+	u_int kd_envid;			// env_id
+	u_int kd_parent_id;		// env_parent_id
+	u_int kd_runs;			// env_runs
+	u_int64_t kd_timebase_hz;	// TIMEBASE_HZ
+	u_int64_t kd_time;		// get_time() at the last env_run
+	u_int64_t kd_runtime;		// env_runtime at the last env_run
+};
+
+struct Env;
+struct Notif;
+struct Page;
+struct Sysring;
+LIST_HEAD(Env_list, Env);
+TAILQ_HEAD(Env_tailq, Env);
+
 struct Env {
 	struct Trapframe env_tf;        // Saved registers
-	LIST_ENTRY(Env) env_link;       // Free list
+	TAILQ_ENTRY(Env) env_link;      // Free list
 	u_int env_id;                   // Unique environment identifier
 	u_int env_parent_id;            // env_id of this env's parent
 	u_int env_status;               // Status of the environment
 	Pde  *env_pgdir;                // Kernel virtual address of page dir
 	u_int env_cr3;
-	LIST_ENTRY(Env) env_sched_link;
+	TAILQ_ENTRY(Env) env_sched_link;
         u_int env_pri;
 	// Lab 4 IPC
 	u_int env_ipc_value;            // data value sent to us 
@@ -34,6 +74,39 @@ struct Env {
 	u_int env_ipc_recving;          // env is blocked receiving
 	u_int env_ipc_dstva;		// va at which to map received page
 	u_int env_ipc_perm;		// perm of page mapping received
+	u_int env_ipc_recv_from;	// only accept this sender, 0 for any
+	u_int env_ipc_mr_len;		// words in env_ipc_mr from the last message
+	u_int64_t env_ipc_mr[IPC_MR_WORDS];	// register message received
+	u_int env_ipc_calling;		// queued send of an ipc_call
+	u_int env_ipc_dstpages;		// pages we accept at env_ipc_dstva
+	u_int env_ipc_npages;		// pages mapped by the last message
+
+	// Blocking send, see lib/ipc.c
+	struct Env_tailq env_ipc_senders;	// senders blocked on us, FIFO
+	TAILQ_ENTRY(Env) env_ipc_send_link;	// on env_ipc_send_to's queue
+	struct Env *env_ipc_send_to;	// receiver we are blocked on
+	u_int env_ipc_send_value;	// the message held while we wait
+	u_int env_ipc_send_srcva;
+	u_int env_ipc_send_npages;
+	u_int env_ipc_send_perm;
+
+	// IPC endpoints, see lib/endpoint.c
+	u_int env_ep_bound;		// endpoint we serve, 0 if none
+	struct Env_tailq *env_ep_queue;	// endpoint queue we are on, or NULL
+	TAILQ_ENTRY(Env) env_ep_link;
+
+	// Notification wait, see lib/notif.c
+	struct Notif *env_notif_wait;	// object we are blocked on, or NULL
+	u_int env_notif_bits;		// bits taken by the last wait
+
+	// Futex wait, see lib/futex.c
+	u_long env_futex_key;		// physical address waited on, 0 if none
+	TAILQ_ENTRY(Env) env_futex_link;	// on its futex hash bucket
+	u_int64_t env_futex_deadline;	// get_cycle() timeout, 0 for none
+
+	// Console input wait, see lib/cons.c
+	TAILQ_ENTRY(Env) env_cons_link;	// on cons_waiters
+	u_int env_cons_waiting;		// blocked in sys_cons_read
 
 	// Lab 4 fault handling
 	u_int env_pgfault_handler;      // page fault state
@@ -42,13 +115,59 @@ struct Env {
 	// Lab 6 scheduler counts
 	u_int env_runs;			// number of times been env_run'ed
 	u_int env_nop;                  // align to avoid mul instruction
+	u_int env_sys_count[__NR_SYSCALLS];	// calls made while sysstat_on
+
+	// Read-only data page mapped at UKDATA
+	struct Page *env_kdata_page;	// holds a reference of its own
+	struct Kdata *env_kdata;	// kernel view of it
+
+	// Batched syscalls, see lib/sysring.c
+	struct Page *env_sysring_page;	// ring page, referenced while set
+	struct Sysring *env_sysring;	// kernel view of it, or NULL
+
+	// Scheduling classes and runtime accounting
+	u_int env_sched_class;		// SCHED_FAIR, SCHED_RR or SCHED_EDF
+	u_int env_on_rq;		// queued on its class's runqueue
+	u_int env_rr_list;		// env_sched_list index while SCHED_RR
+	int env_heap_idx;		// slot in the fair-share heap
+	u_int64_t env_exec_start;	// cycle stamp of the last env_run
+	u_int64_t env_runtime;		// total cycles spent running
+	u_int64_t env_vruntime;		// runtime scaled down by env_pri
+	u_int64_t env_switch_cycles;	// cycles env_run spent switching to us
+
+	// Priority inheritance over IPC, see sched_pi_wait()
+	u_int env_inh_pri;		// highest env_pri among our waiters, 0 if none
+	struct Env *env_pi_server;	// env whose reply we are blocked on
+	LIST_ENTRY(Env) env_pi_link;	// on env_pi_server's env_pi_waiters
+	struct Env_list env_pi_waiters;	// clients blocked on our reply
+
+	// CPU affinity
+	u_int env_hartmask;		// harts it may run on, bit per hart
+	u_int env_last_hart;		// hart it last ran on
+	u_int env_migrations;		// times it ran on a different hart
+
+	// Deadline reservation (SCHED_EDF), all in cycles
+	LIST_ENTRY(Env) env_dl_link;	// edf runqueue or throttled list
+	u_int env_dl_throttled;		// budget spent, waiting for next period
+	u_int env_dl_bw;		// runtime/period, fixed point (1 << 20 = cpu)
+	u_int64_t env_dl_runtime;	// budget granted each period
+	u_int64_t env_dl_period;	// replenishment period
+	u_int64_t env_dl_deadline;	// deadline relative to period start
+	u_int64_t env_dl_abs;		// absolute deadline of current period
+	u_int64_t env_dl_next;		// start of the next period
+	u_int64_t env_dl_budget;	// budget left in current period
+	u_int64_t env_dl_wakeup;	// cycle it became runnable, 0 if seen
+
+	// Lazily switched FP state, see lib/fpu.c
+	u_int env_fp_used;		// env_fp holds state worth loading
+	u_int env_fp_saves;		// times env_fp was written back
+	struct Fpstate env_fp;		// FP regs while another env owns the FPU
 };
 
-LIST_HEAD(Env_list, Env);
 extern struct Env *envs;		// All environments
 extern struct Env *envs_paddr;		// PADDR of envs
 extern struct Env *curenv;	        // the current env
-extern struct Env_list env_sched_list[2]; // runnable env list
+extern struct Env_tailq env_sched_list[2]; // runnable env list
 
 void env_init(void);
 int env_alloc(struct Env **e, u_int parent_id);
@@ -67,19 +186,19 @@ void env_run(struct Env *e);
 	extern u_char x[], y[]; \
 	env_create(x, (int)y); \
 }
+/* Start user/x.elf, linked in by `ld -r -b binary` as user/x.bin. The
+ * _size symbol that ld defines is absolute, so take _end - _start. */
 #define ENV_CREATE_PRIORITY(x, y) \
 {\
-        extern u_char binary_##x##_start[]; \
-        extern u_int binary_##x##_size;\
-        env_create_priority(binary_##x##_start, \
-                (u_int)binary_##x##_size, y);\
+        extern u_char _binary_##x##_elf_start[], _binary_##x##_elf_end[]; \
+        env_create_priority(_binary_##x##_elf_start, \
+                (u_int)(_binary_##x##_elf_end - _binary_##x##_elf_start), y);\
 }
 #define ENV_CREATE(x) \
 { \
-	extern u_char binary_##x##_start[];\
-	extern u_int binary_##x##_size; \
-	env_create(binary_##x##_start, \
-		(u_int)binary_##x##_size); \
+	extern u_char _binary_##x##_elf_start[], _binary_##x##_elf_end[]; \
+	env_create(_binary_##x##_elf_start, \
+		(u_int)(_binary_##x##_elf_end - _binary_##x##_elf_start)); \
 }
 
 #endif // !_ENV_H_
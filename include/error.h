@@ -21,6 +21,11 @@
 #define E_FILE_EXISTS	11	// File already exists
 #define E_NOT_EXEC	12	// File not a valid executable
 
-#define MAXERROR 12
+// Scheduler error codes
+#define E_NO_BANDWIDTH	13	// Deadline reservation would overcommit the cpu
+#define E_TIMEOUT	14	// Wait timed out
+#define E_AGAIN		15	// Futex word no longer holds the expected value
+
+#define MAXERROR 15
 
 #endif // _ERROR_H_
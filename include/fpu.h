@@ -0,0 +1,21 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _FPU_H_
+#define _FPU_H_
+
+#include <env.h>
+
+/* The FPU holds one env's registers at a time (fpu_owner). Every other
+ * env runs with sstatus.FS Off, so its first FP instruction traps and
+ * fpu_trap() moves the registers over; envs that never use FP pay
+ * nothing on a switch. */
+extern struct Env *fpu_owner;
+
+void fpu_save(struct Fpstate *fp);
+void fpu_restore(struct Fpstate *fp);
+
+int fpu_trap(struct Trapframe *tf);
+void fpu_fork(struct Env *parent, struct Env *child);
+void fpu_release(struct Env *e);
+
+#endif /* _FPU_H_ */
@@ -55,6 +55,9 @@ struct Super {
 
 // Definitions for requests from clients to file system
 
+// Requests small enough to fit a register message (SET_SIZE, CLOSE and
+// DIRTY) arrive with no page: the fields of their Fsreq_* struct are in
+// env_ipc_mr[] in declaration order.
 #define FSREQ_OPEN	1
 #define FSREQ_MAP	2
 #define FSREQ_SET_SIZE	3
@@ -0,0 +1,18 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _FUTEX_H_
+#define _FUTEX_H_
+
+#include <env.h>
+
+#define FUTEX_BUCKETS	64
+
+void futex_init(void);
+int futex_key(struct Env *e, u_int va, u_long *key, volatile u_int **kva);
+void futex_wait(struct Env *e, u_long key, u_int timeout);
+int futex_wake(u_long key, u_int n);
+void futex_wake_page(u_long pa);
+void futex_expire(void);
+void futex_exit(struct Env *e);
+
+#endif /* _FUTEX_H_ */
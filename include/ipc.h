@@ -0,0 +1,22 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _IPC_H_
+#define _IPC_H_
+
+#include <env.h>
+
+/* A sender passes up to IPC_MR_WORDS message words in s2..s9 and their
+ * count in a6; see msyscall_mr in user/syscall_wrap.S. */
+#define IPC_MR_LEN_REG		16	/* a6 */
+#define IPC_MR_FIRST_REG	18	/* s2 */
+
+int ipc_can_deliver(struct Env *from, struct Env *to);
+int ipc_deliver(struct Env *from, struct Env *to, u_int value, u_int srcva,
+                u_int npages, u_int perm);
+void ipc_queue_sender(struct Env *from, struct Env *to, u_int value,
+                      u_int srcva, u_int npages, u_int perm);
+struct Env *ipc_complete_sender(struct Env *to);
+void ipc_wait_reply(struct Env *e, struct Env *server);
+void ipc_exit(struct Env *e);
+
+#endif /* _IPC_H_ */
@@ -3,7 +3,37 @@
 #ifndef _KCLOCK_H_
 #define _KCLOCK_H_
 #define	IO_RTC		0xb5000100		/* RTC port */
+#define	KCLOCK_TICK	100000			/* `time` ticks per clock interrupt: 100Hz */
 #ifndef __ASSEMBLER__
+#include <types.h>
+
 void kclock_init(void);
+void set_timer(void);
+
+/* Overview:
+ *  Read the free-running `cycle` counter. Usable from user mode once
+ *  kclock_init() has opened scounteren.
+ */
+static inline u_int64_t get_cycle(void)
+{
+	u_int64_t c;
+
+	asm volatile("rdcycle %0" : "=r"(c));
+	return c;
+}
+
+#define TIMEBASE_HZ	10000000UL	/* `time` ticks per second on QEMU virt */
+
+/* Overview:
+ *  Read the fixed-rate `time` counter, TIMEBASE_HZ ticks a second.
+ *  Usable from user mode once kclock_init() has opened scounteren.
+ */
+static inline u_int64_t get_time(void)
+{
+	u_int64_t t;
+
+	asm volatile("rdtime %0" : "=r"(t));
+	return t;
+}
 #endif /* !__ASSEMBLER__ */
 #endif
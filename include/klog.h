@@ -0,0 +1,39 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _KLOG_H_
+#define _KLOG_H_
+
+/* Kernel log levels, most severe first. */
+#define KLOG_ERR	0
+#define KLOG_WARN	1
+#define KLOG_INFO	2
+#define KLOG_DEBUG	3
+
+#define KLOG_SIZE	16384	// bytes of log kept in memory, a power of two
+#define KLOG_MASK	(KLOG_SIZE - 1)
+
+// Debug records are compiled in only with `make DEBUG=1`.
+#ifndef KLOG_LEVEL
+#ifdef KDEBUG
+#define KLOG_LEVEL	KLOG_DEBUG
+#else
+#define KLOG_LEVEL	KLOG_INFO
+#endif
+#endif
+
+extern int klog_console;	// records up to this level reach the console
+
+void klog(int level, char *fmt, ...);
+void klog_flush(void);
+void klog_dump(void);
+
+#define klog_err(...)	klog(KLOG_ERR, __VA_ARGS__)
+#define klog_warn(...)	klog(KLOG_WARN, __VA_ARGS__)
+#define klog_info(...)	klog(KLOG_INFO, __VA_ARGS__)
+#if KLOG_LEVEL >= KLOG_DEBUG
+#define klog_debug(...)	klog(KLOG_DEBUG, __VA_ARGS__)
+#else
+#define klog_debug(...)	do { } while (0)
+#endif
+
+#endif /* _KLOG_H_ */
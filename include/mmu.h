@@ -16,6 +16,7 @@
 #define MODE_BARE	0
 #define MODE_SV39	8
 #define MODE_SV48	9
+#define MAKE_SATP(mode, ppn)	(((u_int64_t)(mode) << 60) | (u_int64_t)(ppn))
 
 #define BY2PG		((u_int64_t)4096)	// bytes to a page
 #define PDMAP		(4*1024*1024)	// bytes mapped by a page directory entry
@@ -63,8 +64,8 @@
  o     4G ----------->  +----------------------------+------------0x100000000
  o                      |       ...                  |  kseg3
  o                      +----------------------------+------------0xe000 0000
- o                      |       ...                  |  kseg2
- o                      +----------------------------+------------0xc000 0000
+ o                      |     device registers       |  kseg2
+ o      KDEV    ----->  +----------------------------+------------0xc000 0000
  o                      |   Interrupts & Exception   |  kseg1
  o                      +----------------------------+------------0xa000 0000
  o                      |      Invalid memory        |   /|\
@@ -87,8 +88,8 @@
  o  UTOP,UENVS   -----> +----------------------------+------------0x7f40 0000    |
  o  UXSTACKTOP -/       |     user exception stack   |     BY2PG                 |
  o                      +----------------------------+------------0x7f3f f000    |
- o                      |       Invalid memory       |     BY2PG                 |
- o      USTACKTOP ----> +----------------------------+------------0x7f3f e000    |
+ o                      |  kernel data page (R/O)    |     BY2PG                 |
+ o UKDATA,USTACKTOP --> +----------------------------+------------0x7f3f e000    |
  o                      |     normal user stack      |     BY2PG                 |
  o                      +----------------------------+------------0x7f3f d000    |
  a                      |                            |                           |
@@ -105,6 +106,7 @@
 */
 
 #define KERNBASE 0x80010000
+#define KDEV 0xc0000000
 
 #define VPT (ULIM + PDMAP )
 #define KSTACKTOP (VPT-0x100)
@@ -117,8 +119,8 @@
 
 #define UTOP UENVS
 #define UXSTACKTOP (UTOP)
-#define TIMESTACK 0x82000000
 
+#define UKDATA (UTOP - 2*BY2PG)
 #define USTACKTOP (UTOP - 2*BY2PG)
 #define UTEXT 0x00400000
 
@@ -140,7 +142,12 @@
 #define E_FILE_EXISTS	11	// File already exists
 #define E_NOT_EXEC	12	// File not a valid executable
 
-#define MAXERROR 12
+// Scheduler error codes
+#define E_NO_BANDWIDTH	13	// Deadline reservation would overcommit the cpu
+#define E_TIMEOUT	14	// Wait timed out
+#define E_AGAIN		15	// Futex word no longer holds the expected value
+
+#define MAXERROR 15
 
 #ifndef __ASSEMBLER__
 
@@ -0,0 +1,28 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _NOTIF_H_
+#define _NOTIF_H_
+
+#include <env.h>
+
+#define NNOTIF		64
+#define NOTIFX(id)	((id) & (NNOTIF - 1))
+
+// A word of pending event bits. Anyone may signal it without blocking;
+// only its owner waits on it, and takes all pending bits at once.
+struct Notif {
+    u_int n_id;			// 0 while free
+    u_int n_owner;		// envid that allocated it
+    u_int n_bits;		// signalled, not yet taken
+    struct Env *n_waiter;	// owner blocked in notif_wait, or NULL
+};
+
+int notif_alloc(struct Env *owner, u_int *id);
+int notif_lookup(u_int id, struct Notif **n);
+void notif_free(struct Notif *n);
+void notif_signal(struct Notif *n, u_int bits);
+int notif_wait(struct Env *e, struct Notif *n);
+void notif_cancel(struct Env *e);
+void notif_exit(struct Env *e);
+
+#endif /* _NOTIF_H_ */
@@ -0,0 +1,24 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _PLIC_H_
+#define _PLIC_H_
+
+#include <types.h>
+#include <mmu.h>
+#include <trap.h>
+
+/* Platform-level interrupt controller of QEMU virt, mapped at KDEV.
+ * Each hart has an M-mode and an S-mode context; we use the S one. */
+#define PLIC_PA			0x0c000000
+#define PLIC_SIZE		0x400000
+#define PLIC			KDEV
+#define PLIC_PRIORITY(irq)	(PLIC + 4 * (irq))
+#define PLIC_SENABLE(hart)	(PLIC + 0x2080 + (hart) * 0x100)
+#define PLIC_STHRESHOLD(hart)	(PLIC + 0x201000 + (hart) * 0x2000)
+#define PLIC_SCLAIM(hart)	(PLIC + 0x201004 + (hart) * 0x2000)
+
+void plic_init(void);
+void plic_enable(u_int irq);
+void plic_intr(struct Trapframe *tf);
+
+#endif /* _PLIC_H_ */
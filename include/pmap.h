@@ -91,11 +91,14 @@ void page_check();
 int page_alloc(struct Page **pp);
 void page_free(struct Page *pp);
 void page_decref(struct Page *pp);
-int pgdir_walk(Pte *vpt2, u_int64_t va, int create, Pte **vpt0e);
+int vpt2_walk(Pte *vpt2, u_int64_t va, int create, Pte **vpt0e);
 int page_insert(Pte *vpt2, struct Page *pp, u_int64_t va, u_int perm);
+int page_insert_batch(Pte *vpt2, struct Page *pp, u_int64_t va, u_int perm);
 struct Page *page_lookup(Pte *vpt2, u_int64_t va, Pte **vpt0e);
 void page_remove(Pte *vpt2, u_int64_t va) ;
 void tlb_invalidate(Pte *vpt2, u_int64_t va);
+void tlb_batch_begin(void);
+void tlb_batch_end(void);
 
 void boot_map_segment(Pde *pgdir, u_long va, u_long size, u_long pa, u_int64_t perm);
 
@@ -149,25 +149,22 @@
 
 /*
  * Insert the element "elm" at the tail of the list named "head".
- * The "field" name is the link element as above. You can refer to LIST_INSERT_HEAD.
- * Note: this function has big differences with LIST_INSERT_HEAD !
+ * The "field" name is the link element as above.
+ * A list has no tail pointer, so this walks the whole list; use a
+ * tail queue when elements are appended often.
  */
 #define LIST_INSERT_TAIL(head, elm, field) do {                                            \
                 if (LIST_EMPTY(head)) {                                                    \
                         LIST_INSERT_HEAD(head, elm, field);                                \
                 }                                                                          \
                 else {                                                                     \
-                        LIST_NEXT((elm), field) = LIST_FIRST((head));                      \
-                        while (LIST_NEXT((LIST_FIRST(head)), field) != NULL) {             \
-                                LIST_FIRST((head)) = LIST_NEXT((LIST_FIRST(head)), field); \
+                        typeof(elm) _lit_last = LIST_FIRST((head));                        \
+                        while (LIST_NEXT(_lit_last, field) != NULL) {                      \
+                                _lit_last = LIST_NEXT(_lit_last, field);                   \
                         }                                                                  \
-                        LIST_NEXT((LIST_FIRST(head)), field) = (elm);                      \
-                        (elm)->field.le_prev = &LIST_NEXT((LIST_FIRST(head)), field);      \
-                        LIST_FIRST((head)) = LIST_NEXT((elm), field);                      \
-                        LIST_NEXT((elm), field) = NULL;                                    \
+                        LIST_INSERT_AFTER(_lit_last, elm, field);                          \
                 }                                                                          \
         } while (0)
-/* finish your code here. */
 
 
 #define LIST_NEXT(elm, field)   ((elm)->field.le_next)
@@ -185,6 +182,9 @@
 
 /*
  * Tail queue definitions.
+ *
+ * Like a list, plus a pointer to the last element's next field, so
+ * insertion at either end and removal are O(1). Removal needs the head.
  */
 #define TAILQ_HEAD(name, type)                                                  \
         struct name {                                                           \
@@ -192,10 +192,208 @@
                 struct type **tqh_last; /* addr of last next element */         \
         }
 
+#define TAILQ_HEAD_INITIALIZER(head)                                            \
+        { NULL, &(head).tqh_first }
+
 #define TAILQ_ENTRY(type)                                                       \
         struct {                                                                \
                 struct type *tqe_next;  /* next element */                      \
                 struct type **tqe_prev; /* address of previous next element */  \
         }
 
+/*
+ * Tail queue functions.
+ */
+#define TAILQ_EMPTY(head)               ((head)->tqh_first == NULL)
+
+#define TAILQ_FIRST(head)               ((head)->tqh_first)
+
+#define TAILQ_NEXT(elm, field)          ((elm)->field.tqe_next)
+
+/*
+ * The last element; "headname" is the struct name given to TAILQ_HEAD.
+ */
+#define TAILQ_LAST(head, headname)                                              \
+        (*(((struct headname *)((head)->tqh_last))->tqh_last))
+
+#define TAILQ_FOREACH(var, head, field)                                         \
+        for ((var) = TAILQ_FIRST((head));                                       \
+                 (var);                                                         \
+                 (var) = TAILQ_NEXT((var), field))
+
+#define TAILQ_INIT(head) do {                                                   \
+                TAILQ_FIRST((head)) = NULL;                                     \
+                (head)->tqh_last = &TAILQ_FIRST((head));                        \
+        } while (0)
+
+#define TAILQ_INSERT_HEAD(head, elm, field) do {                                \
+                if ((TAILQ_NEXT((elm), field) = TAILQ_FIRST((head))) != NULL)   \
+                        TAILQ_FIRST((head))->field.tqe_prev =                   \
+                                        &TAILQ_NEXT((elm), field);              \
+                else                                                            \
+                        (head)->tqh_last = &TAILQ_NEXT((elm), field);           \
+                TAILQ_FIRST((head)) = (elm);                                    \
+                (elm)->field.tqe_prev = &TAILQ_FIRST((head));                   \
+        } while (0)
+
+#define TAILQ_INSERT_TAIL(head, elm, field) do {                                \
+                TAILQ_NEXT((elm), field) = NULL;                                \
+                (elm)->field.tqe_prev = (head)->tqh_last;                       \
+                *(head)->tqh_last = (elm);                                      \
+                (head)->tqh_last = &TAILQ_NEXT((elm), field);                   \
+        } while (0)
+
+#define TAILQ_INSERT_AFTER(head, listelm, elm, field) do {                      \
+                if ((TAILQ_NEXT((elm), field) = TAILQ_NEXT((listelm), field)) != NULL) \
+                        TAILQ_NEXT((elm), field)->field.tqe_prev =              \
+                                        &TAILQ_NEXT((elm), field);              \
+                else                                                            \
+                        (head)->tqh_last = &TAILQ_NEXT((elm), field);           \
+                TAILQ_NEXT((listelm), field) = (elm);                           \
+                (elm)->field.tqe_prev = &TAILQ_NEXT((listelm), field);          \
+        } while (0)
+
+#define TAILQ_INSERT_BEFORE(listelm, elm, field) do {                           \
+                (elm)->field.tqe_prev = (listelm)->field.tqe_prev;              \
+                TAILQ_NEXT((elm), field) = (listelm);                           \
+                *(listelm)->field.tqe_prev = (elm);                             \
+                (listelm)->field.tqe_prev = &TAILQ_NEXT((elm), field);          \
+        } while (0)
+
+#define TAILQ_REMOVE(head, elm, field) do {                                     \
+                if (TAILQ_NEXT((elm), field) != NULL)                           \
+                        TAILQ_NEXT((elm), field)->field.tqe_prev =              \
+                                        (elm)->field.tqe_prev;                  \
+                else                                                            \
+                        (head)->tqh_last = (elm)->field.tqe_prev;               \
+                *(elm)->field.tqe_prev = TAILQ_NEXT((elm), field);              \
+        } while (0)
+
+/*
+ * Append all of "head2" to "head1", leaving "head2" empty.
+ */
+#define TAILQ_CONCAT(head1, head2, field) do {                                  \
+                if (!TAILQ_EMPTY((head2))) {                                    \
+                        *(head1)->tqh_last = TAILQ_FIRST((head2));              \
+                        TAILQ_FIRST((head2))->field.tqe_prev = (head1)->tqh_last; \
+                        (head1)->tqh_last = (head2)->tqh_last;                  \
+                        TAILQ_INIT((head2));                                    \
+                }                                                               \
+        } while (0)
+
+/*
+ * Circular queue definitions.
+ *
+ * The first and last elements point back at the head instead of NULL,
+ * so the queue can be walked both ways and every insertion or removal
+ * is O(1) without special-casing the ends.
+ */
+#define CIRCLEQ_HEAD(name, type)                                                \
+        struct name {                                                           \
+                struct type *cqh_first; /* first element */                     \
+                struct type *cqh_last;  /* last element */                      \
+        }
+
+#define CIRCLEQ_HEAD_INITIALIZER(head)                                          \
+        { (void *)&(head), (void *)&(head) }
+
+#define CIRCLEQ_ENTRY(type)                                                     \
+        struct {                                                                \
+                struct type *cqe_next;  /* next element */                      \
+                struct type *cqe_prev;  /* previous element */                  \
+        }
+
+/*
+ * Circular queue functions.
+ */
+#define CIRCLEQ_EMPTY(head)             ((head)->cqh_first == (void *)(head))
+
+#define CIRCLEQ_FIRST(head)             ((head)->cqh_first)
+
+#define CIRCLEQ_LAST(head)              ((head)->cqh_last)
+
+#define CIRCLEQ_NEXT(elm, field)        ((elm)->field.cqe_next)
+
+#define CIRCLEQ_PREV(elm, field)        ((elm)->field.cqe_prev)
+
+/*
+ * Stepping past either end yields the head, not NULL; these wrap
+ * around to the other end instead.
+ */
+#define CIRCLEQ_LOOP_NEXT(head, elm, field)                                     \
+        (((elm)->field.cqe_next == (void *)(head))                              \
+                ? ((head)->cqh_first) : ((elm)->field.cqe_next))
+
+#define CIRCLEQ_LOOP_PREV(head, elm, field)                                     \
+        (((elm)->field.cqe_prev == (void *)(head))                              \
+                ? ((head)->cqh_last) : ((elm)->field.cqe_prev))
+
+#define CIRCLEQ_FOREACH(var, head, field)                                       \
+        for ((var) = CIRCLEQ_FIRST((head));                                     \
+                 (var) != (void *)(head);                                       \
+                 (var) = CIRCLEQ_NEXT((var), field))
+
+#define CIRCLEQ_FOREACH_REVERSE(var, head, field)                               \
+        for ((var) = CIRCLEQ_LAST((head));                                      \
+                 (var) != (void *)(head);                                       \
+                 (var) = CIRCLEQ_PREV((var), field))
+
+#define CIRCLEQ_INIT(head) do {                                                 \
+                (head)->cqh_first = (void *)(head);                             \
+                (head)->cqh_last = (void *)(head);                              \
+        } while (0)
+
+#define CIRCLEQ_INSERT_AFTER(head, listelm, elm, field) do {                    \
+                (elm)->field.cqe_next = (listelm)->field.cqe_next;              \
+                (elm)->field.cqe_prev = (listelm);                              \
+                if ((listelm)->field.cqe_next == (void *)(head))                \
+                        (head)->cqh_last = (elm);                               \
+                else                                                            \
+                        (listelm)->field.cqe_next->field.cqe_prev = (elm);      \
+                (listelm)->field.cqe_next = (elm);                              \
+        } while (0)
+
+#define CIRCLEQ_INSERT_BEFORE(head, listelm, elm, field) do {                   \
+                (elm)->field.cqe_next = (listelm);                              \
+                (elm)->field.cqe_prev = (listelm)->field.cqe_prev;              \
+                if ((listelm)->field.cqe_prev == (void *)(head))                \
+                        (head)->cqh_first = (elm);                              \
+                else                                                            \
+                        (listelm)->field.cqe_prev->field.cqe_next = (elm);      \
+                (listelm)->field.cqe_prev = (elm);                              \
+        } while (0)
+
+#define CIRCLEQ_INSERT_HEAD(head, elm, field) do {                              \
+                (elm)->field.cqe_next = (head)->cqh_first;                      \
+                (elm)->field.cqe_prev = (void *)(head);                         \
+                if ((head)->cqh_last == (void *)(head))                         \
+                        (head)->cqh_last = (elm);                               \
+                else                                                            \
+                        (head)->cqh_first->field.cqe_prev = (elm);              \
+                (head)->cqh_first = (elm);                                      \
+        } while (0)
+
+#define CIRCLEQ_INSERT_TAIL(head, elm, field) do {                              \
+                (elm)->field.cqe_next = (void *)(head);                         \
+                (elm)->field.cqe_prev = (head)->cqh_last;                       \
+                if ((head)->cqh_first == (void *)(head))                        \
+                        (head)->cqh_first = (elm);                              \
+                else                                                            \
+                        (head)->cqh_last->field.cqe_next = (elm);               \
+                (head)->cqh_last = (elm);                                       \
+        } while (0)
+
+#define CIRCLEQ_REMOVE(head, elm, field) do {                                   \
+                if ((elm)->field.cqe_next == (void *)(head))                    \
+                        (head)->cqh_last = (elm)->field.cqe_prev;               \
+                else                                                            \
+                        (elm)->field.cqe_next->field.cqe_prev =                 \
+                                        (elm)->field.cqe_prev;                  \
+                if ((elm)->field.cqe_prev == (void *)(head))                    \
+                        (head)->cqh_first = (elm)->field.cqe_next;              \
+                else                                                            \
+                        (elm)->field.cqe_prev->field.cqe_next =                 \
+                                        (elm)->field.cqe_next;                  \
+        } while (0)
+
 #endif  /* !_SYS_QUEUE_H_ */
@@ -13,8 +13,22 @@
 #define SBI_REMOTE_SFENCE_VMA_ASID 7
 #define SBI_SHUTDOWN 8
 
+/* SBI v0.2+ extensions: a7 = extension id, a6 = function id */
+#define SBI_EXT_BASE 0x10
+#define SBI_BASE_PROBE_EXT 3
+#define SBI_EXT_DBCN 0x4442434E		/* "DBCN", debug console */
+#define SBI_DBCN_WRITE 0
+
+struct sbiret {
+	long error;
+	long value;
+};
+
 extern u_int64_t sys_ecall(u_int64_t, u_int64_t, u_int64_t, u_int64_t);
+extern struct sbiret sbi_call(u_long eid, u_long fid, u_long a0, u_long a1,
+			      u_long a2);
 
 void sbi_console_putchar(unsigned char ch);
+long sbi_debug_console_write(const char *buf, u_long n);
 
 #endif
@@ -3,8 +3,51 @@
 #ifndef __SCHED_H__
 #define __SCHED_H__
 
+#include <env.h>
+
+/* Virtual-runtime credit (in cycles) granted to a fair env waking up,
+ * so an interactive env is picked promptly without banking sleep time. */
+#define SCHED_FAIR_WAKEUP_CREDIT	1000000
+
+/* Deadline class bandwidth, as runtime/period in 1/(1 << SCHED_DL_BW_SHIFT)
+ * units of one cpu. Admission keeps the reserved sum under the limit so
+ * the best-effort classes are never starved outright. */
+#define SCHED_DL_BW_SHIFT	20
+#define SCHED_DL_BW_LIMIT	((95 << SCHED_DL_BW_SHIFT) / 100)
+
+/* Buckets of the wakeup-to-run latency histogram; bucket i counts
+ * delays in [2^i, 2^(i+1)) cycles. */
+#define SCHED_LAT_BUCKETS	32
+
+/* CPU affinity: bit h of env_hartmask allows hart h. Only the boot hart
+ * runs the kernel so far, so a mask must include it to be accepted. */
+#define SCHED_MAX_HARTS		32
+#define SCHED_HARTS_ALL		0xffffffff
+
+extern int sched_need_resched;
+extern u_int sched_dl_lat_hist[SCHED_LAT_BUCKETS];
+
 void sched_init(void);
 void sched_yield(void);
+void sched_yield_to(struct Env *e);
 void sched_intr(int);
 
+void sched_enqueue(struct Env *e);
+void sched_dequeue(struct Env *e);
+void sched_update_curr(struct Env *e);
+void sched_skip_once(struct Env *e);
+int sched_set_class(struct Env *e, u_int class);
+int sched_set_deadline(struct Env *e, u_int64_t runtime, u_int64_t period,
+                       u_int64_t deadline);
+void sched_exit(struct Env *e);
+void sched_dl_latency_dump(void);
+u_int sched_eff_pri(struct Env *e);
+void sched_pi_wait(struct Env *e, struct Env *server);
+void sched_pi_unwait(struct Env *e);
+u_int sched_this_hart(void);
+u_int sched_online_harts(void);
+int sched_allowed(struct Env *e);
+int sched_can_yield_to(struct Env *e);
+int sched_set_affinity(struct Env *e, u_int hartmask);
+
 #endif /* __SCHED_H__ */
@@ -32,52 +32,65 @@ nop*/
 //lui	k1,%hi(kernelsp)
 //lw	k1,%lo(kernelsp)(k1)  //not clear right now
 
-//1:
-csrw	sscratch, sp
+/*
+ * While an env runs in user mode sscratch holds &curenv->env_tf, so the
+ * registers go straight into the env and nothing is copied on a switch.
+ * In the kernel sscratch is 0 and the frame is pushed on the current
+ * stack. Either way tp points at the saved Trapframe afterwards.
+ */
+csrrw	tp, sscratch, tp	/* tp <- trapframe, sscratch <- user tp */
+bnez	tp, 1f
+csrrw	tp, sscratch, tp	/* from the kernel: undo the swap */
+sd	sp, (TF_REG2 - TF_SIZE)(sp)
 addi	sp, sp, -TF_SIZE
-sd	x0, TF_REG0(sp)
-sd	x1, TF_REG1(sp)
-/* sp is x2, modified so don't save it */
-//sd	x2,TF_REG2(sp)
-sd	x3, TF_REG3(sp)
-sd	x4, TF_REG4(sp)
-sd	x5, TF_REG5(sp)
-sd	x6, TF_REG6(sp)
-sd	x7, TF_REG7(sp)
-sd	x8, TF_REG8(sp)
-sd	x9, TF_REG9(sp)
-sd	x10, TF_REG10(sp)
-sd	x11, TF_REG11(sp)
-sd	x12, TF_REG12(sp)
-sd	x13, TF_REG13(sp)
-sd	x14, TF_REG14(sp)
-sd	x15, TF_REG15(sp)
-sd	x16, TF_REG16(sp)
-sd	x17, TF_REG17(sp)
-sd	x18, TF_REG18(sp)
-sd	x19, TF_REG19(sp)
-sd	x20, TF_REG20(sp)
-sd	x21, TF_REG21(sp)
-sd	x22, TF_REG22(sp)
-sd	x23, TF_REG23(sp)
-sd	x24, TF_REG24(sp)
-sd	x25, TF_REG25(sp)
-sd	x26, TF_REG26(sp)
-sd	x27, TF_REG27(sp)
-sd	x28, TF_REG28(sp)
-sd	x30, TF_REG30(sp)
-sd	x31, TF_REG31(sp)
-csrrw	s0, sscratch, x0 /* Extract sp and set sscratch to 0 */
+sd	tp, TF_REG4(sp)
+mv	tp, sp
+j	2f
+1:
+sd	sp, TF_REG2(tp)
+csrr	sp, sscratch
+sd	sp, TF_REG4(tp)		/* user tp */
+ld	sp, KERNEL_SP		/* kernel stack starts empty on every entry */
+2:
+sd	x1, TF_REG1(tp)
+sd	x3, TF_REG3(tp)
+sd	x5, TF_REG5(tp)
+sd	x6, TF_REG6(tp)
+sd	x7, TF_REG7(tp)
+sd	x8, TF_REG8(tp)
+sd	x9, TF_REG9(tp)
+sd	x10, TF_REG10(tp)
+sd	x11, TF_REG11(tp)
+sd	x12, TF_REG12(tp)
+sd	x13, TF_REG13(tp)
+sd	x14, TF_REG14(tp)
+sd	x15, TF_REG15(tp)
+sd	x16, TF_REG16(tp)
+sd	x17, TF_REG17(tp)
+sd	x18, TF_REG18(tp)
+sd	x19, TF_REG19(tp)
+sd	x20, TF_REG20(tp)
+sd	x21, TF_REG21(tp)
+sd	x22, TF_REG22(tp)
+sd	x23, TF_REG23(tp)
+sd	x24, TF_REG24(tp)
+sd	x25, TF_REG25(tp)
+sd	x26, TF_REG26(tp)
+sd	x27, TF_REG27(tp)
+sd	x28, TF_REG28(tp)
+sd	x29, TF_REG29(tp)
+sd	x30, TF_REG30(tp)
+sd	x31, TF_REG31(tp)
+csrw	sscratch, x0		/* we are in the kernel now */
 csrr	s1, sstatus
 csrr	s2, sepc
 csrr	s3, stval
 csrr	s4, scause
-
-sd	s0, TF_REG2(sp) /* save sp */
-sd	s1, TF_STATUS(sp)
-sd	s2, TF_EPC(sp)
-sd	s3, TF_TVAL(sp)
-sd	s4, TF_CAUSE(sp)
+sd	s1, TF_STATUS(tp)
+sd	s2, TF_EPC(tp)
+sd	s2, TF_PC(tp)
+sd	s3, TF_TVAL(tp)
+sd	s4, TF_CAUSE(tp)
 /*move	xk0, sp
 get_sp
 move	k1, sp
@@ -183,6 +196,7 @@ lw	$1, TF_REG1(sp)
 .endm
 */
 .macro RESTORE_ALL
+/* sp points at the Trapframe; sp itself is loaded last */
 ld	s1, TF_STATUS(sp)
 ld	s2, TF_EPC(sp)
 csrw	sstatus, s1
@@ -190,10 +204,10 @@ csrw	sepc, s2
 
 ld	x31, TF_REG31(sp)
 ld	x30, TF_REG30(sp)
-ld	x29, TF_REG30(sp)
+ld	x29, TF_REG29(sp)
 ld	x28, TF_REG28(sp)
-ld	x27, TF_REG30(sp)
-ld	x26, TF_REG30(sp)
+ld	x27, TF_REG27(sp)
+ld	x26, TF_REG26(sp)
 ld	x25, TF_REG25(sp)
 ld	x24, TF_REG24(sp)
 ld	x23, TF_REG23(sp)
@@ -0,0 +1,53 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _SYSRING_H_
+#define _SYSRING_H_
+
+#include <types.h>
+
+#define SYSRING_ENTRIES	64	// slots in each queue, a power of two
+#define SYSRING_MASK	(SYSRING_ENTRIES - 1)
+
+// sys_sysring_enter flags
+#define SYSRING_STOP	0x1	// leave the rest queued after a failure
+
+// A queued syscall: sq_sysno is one of the SYS_* numbers that
+// sys_sysring_enter accepts, sq_args its first five arguments.
+struct Sysring_sqe {
+	u_int sq_sysno;
+	u_int sq_args[5];
+	u_int64_t sq_data;		// handed back in the completion
+};
+
+struct Sysring_cqe {
+	u_int64_t cq_data;		// sq_data of the entry
+	int cq_ret;			// what the syscall returned
+	u_int cq_pad;
+};
+
+// One page shared by an env and the kernel. Indices count entries ever
+// queued and wrap at 2^32; the user owns sr_sq_tail and sr_cq_head, the
+// kernel the other two and the batch results.
+struct Sysring {
+	volatile u_int sr_sq_head;	// next entry the kernel takes
+	volatile u_int sr_sq_tail;	// next free submission slot
+	volatile u_int sr_cq_head;	// next completion to reap
+	volatile u_int sr_cq_tail;	// next free completion slot
+
+	// results of the last sys_sysring_enter
+	u_int sr_errors;		// entries that returned < 0
+	u_int sr_first_error;		// sq index of the first, if any
+	u_int sr_pad[2];
+
+	struct Sysring_sqe sr_sq[SYSRING_ENTRIES];
+	struct Sysring_cqe sr_cq[SYSRING_ENTRIES];
+};
+
+struct Env;
+
+int sysring_register(struct Env *e, u_long va);
+int sysring_run(struct Env *e, u_int flags,
+                int (*run)(struct Sysring_sqe *sqe));
+void sysring_exit(struct Env *e);
+
+#endif /* _SYSRING_H_ */
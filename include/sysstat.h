@@ -0,0 +1,37 @@
+/* See COPYRIGHT for copyright information. */
+
+#ifndef _SYSSTAT_H_
+#define _SYSSTAT_H_
+
+#include <types.h>
+#include <unistd.h>
+
+/* Buckets of the per-syscall latency histogram; bucket i counts calls
+ * that took [2^i, 2^(i+1)) cycles from dispatch to return. */
+#define SYSSTAT_BUCKETS	32
+
+// sys_sysstat operations
+#define SYSSTAT_ENABLE	0	// arg 1 starts counting, 0 stops it
+#define SYSSTAT_RESET	1	// zero all counters, per-env ones included
+#define SYSSTAT_GET	2	// copy syscall arg's struct Sysstat to dstva
+#define SYSSTAT_DUMP	3	// print the table on the console
+#define SYSSTAT_DL_DUMP	4	// print the edf wakeup latency histogram
+
+// Counters of one syscall while instrumentation is enabled. A call
+// that blocks or switches envs never returns to the dispatcher, so it
+// is in st_calls but not in the histogram.
+struct Sysstat {
+	u_int64_t st_calls;
+	u_int64_t st_cycles;		// total over the calls that returned
+	u_int st_hist[SYSSTAT_BUCKETS];
+};
+
+extern int sysstat_on;
+extern struct Sysstat sysstats[__NR_SYSCALLS];
+
+long sysstat_call(long a0, long a1, long a2, long a3, long a4, long a5,
+                  long (*fn)(long, long, long, long, long, long));
+void sysstat_reset(void);
+void sysstat_dump(void);
+
+#endif /* _SYSSTAT_H_ */
@@ -18,12 +18,30 @@
 /* 14 is reserved */
 #define T_STPGFLT		15    /* store page fault */
 
+/* Interrupt causes (scause with its top bit set). In vectored mode
+ * stvec sends interrupt n to stvec base + 4 * n; see boot/start.S. */
+#define IRQ_S_SOFT		1    /* supervisor software */
+#define IRQ_S_TIMER		5    /* supervisor timer */
+#define IRQ_S_EXT		9    /* supervisor external */
+#define STVEC_VECTORED		1
+#define SIE_STIE		0x20	/* sie: timer interrupt enable */
+#define SIE_SEIE		0x200	/* sie: external interrupt enable */
+#define SSTATUS_SIE		0x2	/* interrupts on while in S-mode */
+#define SIP_SSIP		0x2	/* sip: software interrupt pending */
+
 /* These are arbitrarily chosen, but with care not to overlap
  * processor defined exceptions or interrupt vectors.
  */
 //#define T_SYSCALL   0x30 /* system call */
 //#define T_DEFAULT   500  /* catchall */
 
+#define SSTATUS_SPP		0x100	/* trap came from S-mode */
+#define SSTATUS_FS		0x6000	/* FP unit state field */
+#define SSTATUS_FS_OFF		0x0000	/* FP instructions trap */
+#define SSTATUS_FS_INITIAL	0x2000
+#define SSTATUS_FS_CLEAN	0x4000	/* regs match the saved copy */
+#define SSTATUS_FS_DIRTY	0x6000	/* regs written since last save */
+
 #define REGLEN_RISC_V	8 /* Register length in RISC-V, 8 Byte for RV64 */
 
 #ifndef __ASSEMBLER__
@@ -41,6 +59,12 @@ struct Trapframe { //lr:need to be modified(reference to linux pt_regs) TODO
 	u_int64_t epc;
 	u_int64_t pc;
 };
+
+/* FP registers, saved only when an env's FS state is Dirty (lib/fpu.c) */
+struct Fpstate {
+	u_int64_t f[32];
+	u_int64_t fcsr;
+};
 void *set_except_vector(int n, void *addr);
 void trap_init();
 
@@ -96,4 +120,8 @@ void trap_init();
  * Size of stack frame, word/double word alignment
  */
 #define TF_SIZE		((TF_PC) + REGLEN_RISC_V)
+
+/* struct Fpstate */
+#define FP_FCSR		(32 * REGLEN_RISC_V)
+#define FP_SIZE		((FP_FCSR) + REGLEN_RISC_V)
 #endif /* _TRAP_H_ */
@@ -2,7 +2,7 @@
 #define UNISTD_H
 
 #define __SYSCALL_BASE 9527
-#define __NR_SYSCALLS 20
+#define __NR_SYSCALLS 40
 
 
 #define SYS_putchar 		((__SYSCALL_BASE ) + (0 ) )
@@ -22,4 +22,27 @@
 #define SYS_cgetc		((__SYSCALL_BASE ) + (14) )
 #define SYS_write_dev		((__SYSCALL_BASE ) + (15) )
 #define SYS_read_dev		((__SYSCALL_BASE ) + (16) )
+#define SYS_set_sched		((__SYSCALL_BASE ) + (17) )
+#define SYS_set_deadline	((__SYSCALL_BASE ) + (18) )
+#define SYS_yield_to		((__SYSCALL_BASE ) + (19) )
+#define SYS_set_affinity	((__SYSCALL_BASE ) + (20) )
+#define SYS_ipc_send		((__SYSCALL_BASE ) + (21) )
+#define SYS_ipc_call		((__SYSCALL_BASE ) + (22) )
+#define SYS_ipc_reply_recv	((__SYSCALL_BASE ) + (23) )
+#define SYS_notif_alloc		((__SYSCALL_BASE ) + (24) )
+#define SYS_notif_free		((__SYSCALL_BASE ) + (25) )
+#define SYS_notif_signal	((__SYSCALL_BASE ) + (26) )
+#define SYS_notif_wait		((__SYSCALL_BASE ) + (27) )
+#define SYS_futex_wait		((__SYSCALL_BASE ) + (28) )
+#define SYS_futex_wake		((__SYSCALL_BASE ) + (29) )
+#define SYS_ipc_recv_pages	((__SYSCALL_BASE ) + (30) )
+#define SYS_ipc_send_pages	((__SYSCALL_BASE ) + (31) )
+#define SYS_ep_alloc		((__SYSCALL_BASE ) + (32) )
+#define SYS_ep_bind		((__SYSCALL_BASE ) + (33) )
+#define SYS_ep_call		((__SYSCALL_BASE ) + (34) )
+#define SYS_sysring_setup	((__SYSCALL_BASE ) + (35) )
+#define SYS_sysring_enter	((__SYSCALL_BASE ) + (36) )
+#define SYS_sysstat		((__SYSCALL_BASE ) + (37) )
+#define SYS_cons_read		((__SYSCALL_BASE ) + (38) )
+#define SYS_console_write	((__SYSCALL_BASE ) + (39) )
 #endif
@@ -6,6 +6,12 @@
 //#include <trap.h>
 #include <types.h>
 #include <mmu.h>
+#ifdef IPC_BENCH
+#include <env.h>
+#include <sched.h>
+#include <kclock.h>
+#include <cons.h>
+#endif
 
 extern char aoutcode[];
 extern char boutcode[];
@@ -30,11 +36,39 @@ void riscv_init()
 	
 	//env_init();
 	
-	//ENV_CREATE(user_fktest);
-	//ENV_CREATE(user_pingpong);
+	//ENV_CREATE(fktest);
+	//ENV_CREATE(pingpong);
+	//ENV_CREATE(fairbench);	/* then 3 x ENV_CREATE(fbcpu), 2 x ENV_CREATE(fbipc) */
+	//ENV_CREATE(ctxbench);	/* then ENV_CREATE(ctxpeer) */
+	//ENV_CREATE(pibench);	/* then ENV_CREATE(pisrv), 3 x ENV_CREATE(pihog) */
+	//ENV_CREATE(fanin);	/* then 8 x ENV_CREATE(fanclient) */
+	//ENV_CREATE(rpcbench);	/* then ENV_CREATE(ppserver) */
+	//ENV_CREATE(ringbench);	/* then ENV_CREATE(ringprod) */
+	//ENV_CREATE(nullbench);
+	//ENV_CREATE(batchbench);
+	//ENV_CREATE(sysstat);
+	//ENV_CREATE(dlbench);
+	//ENV_CREATE(eptest);	/* then 3 x ENV_CREATE(epserver) */
+
+#ifdef IPC_BENCH
+	/* make bench: run the IPC benchmark suite and nothing else. The
+	 * order is the envs[] layout in user/pingpong.h. */
+	env_init();
+	ENV_CREATE(pingpong);
+	ENV_CREATE(ppserver);
+	ENV_CREATE(ppclient);
+	ENV_CREATE(ppclient);
+	ENV_CREATE(ppclient);
+	ENV_CREATE(ppclient);
+	trap_init();
+	kclock_init();
+	cons_init();
+	sched_yield();
+#endif
 	
 	//trap_init();
 	//kclock_init();
+	//cons_init();
 
 	
 	//while(1);
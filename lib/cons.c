@@ -0,0 +1,154 @@
+#include <cons.h>
+#include <sched.h>
+#include <error.h>
+#include <sbilib_mos.h>
+
+#define uart_reg(r)	(*(volatile u_char *)(UART0 + (r)))
+
+/* Bytes received but not yet read, and the envs blocked in
+ * sys_cons_read, oldest first. */
+static u_char cons_rx[CONS_RXSIZE];
+static u_int cons_rx_head, cons_rx_tail;	// next to read, next to fill
+static struct Env_tailq cons_waiters = TAILQ_HEAD_INITIALIZER(cons_waiters);
+
+/* Output gathered by cons_putc until the next cons_flush. */
+static char cons_tx[CONS_TXSIZE];
+static u_int cons_tx_head, cons_tx_tail;	// next to send, next to fill
+
+/* Overview:
+ *  Turn on the UART receive interrupt and route it through the PLIC.
+ */
+void
+cons_init(void)
+{
+    uart_reg(UART_FCR) = UART_FCR_FIFO;
+    uart_reg(UART_IER) = UART_IER_RX;
+    plic_enable(UART0_IRQ);
+    plic_init();
+}
+
+/* Move whatever the UART holds into the ring; drop it when full. */
+static void
+cons_drain(void)
+{
+    u_char c;
+
+    while (uart_reg(UART_LSR) & UART_LSR_DR) {
+        c = uart_reg(UART_RBR);
+        if (cons_rx_tail - cons_rx_head < CONS_RXSIZE) {
+            cons_rx[cons_rx_tail++ % CONS_RXSIZE] = c;
+        }
+    }
+}
+
+/* Overview:
+ *  Take the next input byte without blocking.
+ *
+ * Post-Condition:
+ *  Return the byte, or 0 if there is none.
+ */
+int
+cons_getc(void)
+{
+    cons_drain();
+    if (cons_rx_head == cons_rx_tail) {
+        return 0;
+    }
+    return cons_rx[cons_rx_head++ % CONS_RXSIZE];
+}
+
+/* Overview:
+ *  Block `e` until a byte arrives. The caller then yields; `e` resumes
+ *  with the byte in a0.
+ */
+void
+cons_wait(struct Env *e)
+{
+    TAILQ_INSERT_TAIL(&cons_waiters, e, env_cons_link);
+    e->env_cons_waiting = 1;
+    e->env_status = ENV_NOT_RUNNABLE;
+    sched_dequeue(e);
+}
+
+/* Overview:
+ *  UART interrupt: buffer the input and hand one byte to each waiter,
+ *  oldest first, while there are bytes.
+ *
+ * Post-Condition:
+ *  Return the number of envs woken.
+ */
+int
+cons_intr(void)
+{
+    struct Env *e;
+    int woken = 0;
+
+    cons_drain();
+    while ((e = TAILQ_FIRST(&cons_waiters)) != NULL &&
+           cons_rx_head != cons_rx_tail) {
+        TAILQ_REMOVE(&cons_waiters, e, env_cons_link);
+        e->env_cons_waiting = 0;
+        e->env_tf.regs[10] = cons_rx[cons_rx_head++ % CONS_RXSIZE];
+        e->env_status = ENV_RUNNABLE;
+        sched_enqueue(e);
+        woken++;
+    }
+    return woken;
+}
+
+/* Overview:
+ *  Stop `e` waiting for input; called when `e` is freed.
+ */
+void
+cons_exit(struct Env *e)
+{
+    if (e->env_cons_waiting) {
+        TAILQ_REMOVE(&cons_waiters, e, env_cons_link);
+        e->env_cons_waiting = 0;
+    }
+}
+
+/* Overview:
+ *  Queue one output byte, flushing first if the ring is full.
+ */
+void
+cons_putc(int c)
+{
+    if (cons_tx_tail - cons_tx_head == CONS_TXSIZE) {
+        cons_flush();
+    }
+    cons_tx[cons_tx_tail++ % CONS_TXSIZE] = c;
+}
+
+/* Overview:
+ *  Queue `n` output bytes from `s`.
+ */
+void
+cons_write(const char *s, u_int n)
+{
+    while (n-- > 0) {
+        cons_putc(*s++);
+    }
+}
+
+/* Overview:
+ *  Send everything queued: one SBI debug-console call per contiguous
+ *  run of the ring, or a legacy putchar per byte when the firmware has
+ *  no DBCN extension.
+ */
+void
+cons_flush(void)
+{
+    u_int off, n;
+    long r;
+
+    while (cons_tx_head != cons_tx_tail) {
+        off = cons_tx_head % CONS_TXSIZE;
+        n = MIN(cons_tx_tail - cons_tx_head, CONS_TXSIZE - off);
+        if ((r = sbi_debug_console_write(&cons_tx[off], n)) <= 0) {
+            sbi_console_putchar(cons_tx[off]);
+            r = 1;
+        }
+        cons_tx_head += r;
+    }
+}
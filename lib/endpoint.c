@@ -0,0 +1,192 @@
+#include <env.h>
+#include <endpoint.h>
+#include <ipc.h>
+#include <sched.h>
+#include <error.h>
+
+static struct Endpoint endpoints[NENDPOINT];
+static u_int ep_gen;
+
+/* Overview:
+ *  Take a free endpoint for `owner` and return its id in *id. As with
+ *  notification objects, ids carry a generation so stale ones fail.
+ *
+ * Post-Condition:
+ *  Return 0 on success, -E_NO_MEM if all NENDPOINT are in use.
+ */
+int
+ep_alloc(struct Env *owner, u_int *id)
+{
+    struct Endpoint *ep;
+    int i;
+
+    for (i = 0; i < NENDPOINT; i++) {
+        ep = &endpoints[i];
+        if (ep->ep_id == 0) {
+            do {
+                ep->ep_id = (++ep_gen * NENDPOINT) | i;
+            } while (ep->ep_id == 0);
+            ep->ep_owner = owner->env_id;
+            TAILQ_INIT(&ep->ep_receivers);
+            TAILQ_INIT(&ep->ep_senders);
+            *id = ep->ep_id;
+            return 0;
+        }
+    }
+    return -E_NO_MEM;
+}
+
+/* Overview:
+ *  Find the live endpoint named by `id`.
+ *
+ * Post-Condition:
+ *  Return 0 and set *ep, or -E_INVAL.
+ */
+int
+ep_lookup(u_int id, struct Endpoint **ep)
+{
+    struct Endpoint *p = &endpoints[EPX(id)];
+
+    if (id == 0 || p->ep_id != id) {
+        return -E_INVAL;
+    }
+    *ep = p;
+    return 0;
+}
+
+/* Overview:
+ *  Make `e` a server of endpoint `id` (0 to stop): from now on its open
+ *  receives also take calls made to the endpoint. Serving is granted by
+ *  the owner: only the owner, `caller`, may bind an env to its endpoint.
+ *  An env may always unbind itself, and the owner may unbind its
+ *  servers.
+ *
+ * Post-Condition:
+ *  Return 0, or -E_INVAL for a bad id or a caller not allowed to bind.
+ */
+int
+ep_bind(struct Env *caller, struct Env *e, u_int id)
+{
+    struct Endpoint *ep;
+    u_int cur = id != 0 ? id : e->env_ep_bound;
+
+    if (caller != e || id != 0) {
+        if (ep_lookup(cur, &ep) < 0 || ep->ep_owner != caller->env_id) {
+            return -E_INVAL;
+        }
+    }
+    ep_unwait(e);
+    e->env_ep_bound = id;
+    return 0;
+}
+
+/* Overview:
+ *  No server of `ep` is idle: block the caller `e` on the endpoint's
+ *  FIFO, holding its message until a server's receive takes it.
+ */
+void
+ep_queue_sender(struct Env *e, struct Endpoint *ep, u_int value, u_int srcva,
+                u_int perm)
+{
+    e->env_ipc_send_value = value;
+    e->env_ipc_send_srcva = srcva;
+    e->env_ipc_send_npages = 1;
+    e->env_ipc_send_perm = perm;
+    e->env_ipc_calling = 1;
+    TAILQ_INSERT_TAIL(&ep->ep_senders, e, env_ep_link);
+    e->env_ep_queue = &ep->ep_senders;
+    e->env_status = ENV_NOT_RUNNABLE;
+    sched_dequeue(e);
+}
+
+/* Overview:
+ *  `to` is receiving: take the oldest caller queued on the endpoint it
+ *  serves, if `to` would accept it.
+ *
+ * Post-Condition:
+ *  Return the caller, off the endpoint queue, or NULL.
+ */
+struct Env *
+ep_take_sender(struct Env *to)
+{
+    struct Endpoint *ep;
+    struct Env *from;
+
+    if (to->env_ep_bound == 0 || ep_lookup(to->env_ep_bound, &ep) < 0) {
+        return NULL;
+    }
+    from = TAILQ_FIRST(&ep->ep_senders);
+    if (from == NULL || !ipc_can_deliver(from, to)) {
+        return NULL;
+    }
+    ep_unwait(from);
+    return from;
+}
+
+/* Overview:
+ *  `e` is about to block in an open receive: if it serves an endpoint,
+ *  list it as idle there so the next call goes to it.
+ */
+void
+ep_wait(struct Env *e)
+{
+    struct Endpoint *ep;
+
+    if (e->env_ep_bound == 0 || ep_lookup(e->env_ep_bound, &ep) < 0 ||
+        !e->env_ipc_recving || e->env_ipc_recv_from != 0) {
+        return;
+    }
+    TAILQ_INSERT_TAIL(&ep->ep_receivers, e, env_ep_link);
+    e->env_ep_queue = &ep->ep_receivers;
+}
+
+/* Overview:
+ *  Take `e` off the endpoint queue it is on, if any.
+ */
+void
+ep_unwait(struct Env *e)
+{
+    if (e->env_ep_queue != NULL) {
+        TAILQ_REMOVE(e->env_ep_queue, e, env_ep_link);
+        e->env_ep_queue = NULL;
+    }
+}
+
+/* Overview:
+ *  `e` is being freed: leave its endpoint queue, and free the endpoints
+ *  it owns, failing their queued calls with -E_BAD_ENV and unbinding
+ *  their servers, so clients that look up env_ep_bound fall back to
+ *  plain IPC.
+ */
+void
+ep_exit(struct Env *e)
+{
+    struct Endpoint *ep;
+    struct Env *w;
+    int i, j;
+
+    ep_unwait(e);
+    for (i = 0; i < NENDPOINT; i++) {
+        ep = &endpoints[i];
+        if (ep->ep_id == 0 || ep->ep_owner != e->env_id) {
+            continue;
+        }
+        while ((w = TAILQ_FIRST(&ep->ep_receivers)) != NULL) {
+            ep_unwait(w);
+        }
+        while ((w = TAILQ_FIRST(&ep->ep_senders)) != NULL) {
+            ep_unwait(w);
+            w->env_ipc_calling = 0;
+            w->env_tf.regs[10] = -E_BAD_ENV;
+            w->env_status = ENV_RUNNABLE;
+            sched_enqueue(w);
+        }
+        for (j = 0; j < NENV; j++) {
+            if (envs[j].env_ep_bound == ep->ep_id) {
+                envs[j].env_ep_bound = 0;
+            }
+        }
+        ep->ep_id = 0;
+        ep->ep_owner = 0;
+    }
+}
@@ -6,6 +6,14 @@
 #include <env.h>
 #include <kerelf.h>
 #include <sched.h>
+#include <kclock.h>
+#include <fpu.h>
+#include <ipc.h>
+#include <notif.h>
+#include <futex.h>
+#include <endpoint.h>
+#include <sysring.h>
+#include <cons.h>
 #include <pmap.h>
 #include <printf.h>
 
@@ -13,8 +21,8 @@ struct Env *envs = NULL;		// All environments
 struct Env *envs_paddr = NULL;		// PADDR of envs
 struct Env *curenv = NULL;	        // the current env
 
-static struct Env_list env_free_list;	// Free list
-struct Env_list env_sched_list[2];      // Runnable list
+static struct Env_tailq env_free_list;	// Free list
+struct Env_tailq env_sched_list[2];     // Runnable list
 
 extern Pde *boot_vpt2;
 extern char *KERNEL_SP;
@@ -102,9 +110,10 @@ env_init(void)
 {
     int i;
     /*Step 1: Initial env_free_list. */
-    LIST_INIT(&env_free_list);
-    LIST_INIT(&env_sched_list[0]);
-    LIST_INIT(&env_sched_list[1]);
+    TAILQ_INIT(&env_free_list);
+    TAILQ_INIT(&env_sched_list[0]);
+    TAILQ_INIT(&env_sched_list[1]);
+    futex_init();
 
     /*Step 2: Traverse the elements of 'envs' array,
      * set their status as free and insert them into the env_free_list.
@@ -113,7 +122,7 @@ env_init(void)
      * should be the same as it in the envs array. */
     for (i = NENV - 1; i >= 0; --i) {
         envs[i].env_status = ENV_FREE;
-        LIST_INSERT_HEAD(&env_free_list, &envs[i], env_link);
+        TAILQ_INSERT_HEAD(&env_free_list, &envs[i], env_link);
     }
 }
 
@@ -168,6 +177,53 @@ env_setup_vm(struct Env *e)
     return 0;
 }
 
+/* Overview:
+ *  Allocate e's kernel data page, zeroed, and map it read-only at
+ *  UKDATA. The env keeps a second reference so that unmapping UKDATA
+ *  from user mode cannot free the page under us. env_alloc fills in
+ *  the fields that never change.
+ */
+static int
+env_setup_kdata(struct Env *e)
+{
+    struct Page *p;
+    struct Kdata *kd;
+    int r;
+
+    if ((r = page_alloc(&p)) != 0) {
+        return r;
+    }
+    if ((r = page_insert(e->env_pgdir, p, UKDATA, PTE_R | PTE_U)) != 0) {
+        page_free(p);
+        return r;
+    }
+    p->pp_ref++;
+    kd = (struct Kdata *)page2kva(p);
+    bzero(kd, BY2PG);
+    kd->kd_timebase_hz = TIMEBASE_HZ;
+    e->env_kdata_page = p;
+    e->env_kdata = kd;
+    return 0;
+}
+
+/* Overview:
+ *  Refresh the changing part of e's kernel data page before it runs.
+ *  kd_seq is odd while the fields are half written.
+ */
+static void
+env_kdata_update(struct Env *e)
+{
+    struct Kdata *kd = e->env_kdata;
+
+    kd->kd_seq++;
+    asm volatile("fence w, w" ::: "memory");
+    kd->kd_runs = e->env_runs;
+    kd->kd_runtime = e->env_runtime;
+    kd->kd_time = get_time();
+    asm volatile("fence w, w" ::: "memory");
+    kd->kd_seq++;
+}
+
 /* Overview:
  *  Allocates and Initializes a new environment.
  *  On success, the new environment is stored in *new.
@@ -195,12 +251,12 @@ env_alloc(struct Env **new, u_int parent_id)
 	struct Env *e;
     
     /*Step 1: Get a new Env from env_free_list*/
-    if (LIST_EMPTY(&env_free_list)) {
+    if (TAILQ_EMPTY(&env_free_list)) {
 //printf("No free env!\n");
         *new = NULL;
         return -E_NO_FREE_ENV;
     }
-    e = LIST_FIRST(&env_free_list);
+    e = TAILQ_FIRST(&env_free_list);
 
 //printf("had e!\n");
     /*Step 2: Call certain function(has been completed just now) to init kernel memory layout for this new Env.
@@ -208,19 +264,59 @@ env_alloc(struct Env **new, u_int parent_id)
     if ((r = env_setup_vm(e)) != 0) {
         return r;
     }
+    /* Before Step 3 touches e: on failure it is still a free Env. */
+    if ((r = env_setup_kdata(e)) != 0) {
+        page_decref(pa2page(e->env_cr3));
+        e->env_pgdir = 0;
+        e->env_cr3 = 0;
+        return r;
+    }
 
 //printf("env_setup_vm success!\n");
     /*Step 3: Initialize every field of new Env with appropriate values.*/
     e->env_id = mkenvid(e);
     e->env_status = ENV_RUNNABLE;
     e->env_parent_id = parent_id;
+    e->env_runs = 0;
+    bzero(e->env_sys_count, sizeof(e->env_sys_count));
+    e->env_sched_class = SCHED_FAIR;
+    e->env_on_rq = 0;
+    e->env_heap_idx = -1;
+    e->env_runtime = 0;
+    e->env_vruntime = 0;
+    e->env_switch_cycles = 0;
+    e->env_fp_used = 0;
+    e->env_fp_saves = 0;
+    TAILQ_INIT(&e->env_ipc_senders);
+    e->env_ipc_send_to = NULL;
+    e->env_ipc_dstpages = 1;
+    e->env_ipc_npages = 0;
+    e->env_ep_bound = 0;
+    e->env_ep_queue = NULL;
+    e->env_notif_wait = NULL;
+    e->env_notif_bits = 0;
+    e->env_futex_key = 0;
+    e->env_futex_deadline = 0;
+    e->env_inh_pri = 0;
+    e->env_pi_server = NULL;
+    LIST_INIT(&e->env_pi_waiters);
+    e->env_hartmask = SCHED_HARTS_ALL;
+    e->env_last_hart = sched_this_hart();
+    e->env_migrations = 0;
+    e->env_dl_throttled = 0;
+    e->env_dl_bw = 0;
+    e->env_sysring_page = NULL;
+    e->env_cons_waiting = 0;
+    e->env_sysring = NULL;
+    e->env_kdata->kd_envid = e->env_id;
+    e->env_kdata->kd_parent_id = e->env_parent_id;
 
     /*Step 4: Focus on initializing the sp register and cp0_status of env_tf field, located at this new Env. */
     e->env_tf.sstatus = 0x10001004;
-    e->env_tf.regs[29] = USTACKTOP;
+    e->env_tf.regs[2] = USTACKTOP;     // sp
 
     /*Step 5: Remove the new Env from env_free_list. */
-    LIST_REMOVE(e, env_link);
+    TAILQ_REMOVE(&env_free_list, e, env_link);
     *new = e;
     return 0;
 }
@@ -347,7 +443,7 @@ load_icode(struct Env *e, u_char *binary, u_int size)
 
     /*Step 2: Use appropriate perm to set initial stack for new Env. */
     /*Hint: Should the user-stack be writable? */
-    if ((r = page_insert(e->env_pgdir, p, e->env_tf.regs[29] - 1, perm)) != 0) {
+    if ((r = page_insert(e->env_pgdir, p, e->env_tf.regs[2] - 1, perm)) != 0) {
         return;
     }
 
@@ -356,6 +452,7 @@ load_icode(struct Env *e, u_char *binary, u_int size)
 
     /*Step 4:Set CPU's PC register as appropriate value. */
     e->env_tf.pc = entry_point;
+    e->env_tf.epc = entry_point;
 }
 
 /* Overview:
@@ -380,9 +477,9 @@ env_create_priority(u_char *binary, int size, int priority)
     /*Step 2: assign priority to the new env. */
     e->env_pri = priority;
     /*Step 3: Use load_icode() to load the named elf binary,
-      and insert it into env_sched_list using LIST_INSERT_HEAD. */
+      and put it on the runqueue of its scheduling class. */
     load_icode(e, binary, size);
-    LIST_INSERT_HEAD(&env_sched_list[0], e, env_sched_link);
+    sched_enqueue(e);
 }
 
 /* Overview:
@@ -410,6 +507,7 @@ env_free(struct Env *e)
 
     /* Hint: Note the environment's demise.*/
     printf("[%08x] free env %08x\n", curenv ? curenv->env_id : 0, e->env_id);
+    futex_exit(e);
 
     /* Hint: Flush all mapped pages in the user portion of the address space */
     for (pdeno = 0; pdeno < PDX(UTOP); pdeno++) {
@@ -429,15 +527,25 @@ env_free(struct Env *e)
         e->env_pgdir[pdeno] = 0;
         page_decref(pa2page(pa));
     }
+    /* Hint: drop the kernel data page; the loop above took its mapping. */
+    page_decref(e->env_kdata_page);
+    e->env_kdata_page = NULL;
+    e->env_kdata = NULL;
     /* Hint: free the page directory. */
     pa = e->env_cr3;
     e->env_pgdir = 0;
     e->env_cr3 = 0;
     page_decref(pa2page(pa));
     /* Hint: return the environment to the free list. */
+    ipc_exit(e);
+    ep_exit(e);
+    notif_exit(e);
+    sysring_exit(e);
+    cons_exit(e);
+    sched_exit(e);
+    fpu_release(e);
     e->env_status = ENV_FREE;
-    LIST_INSERT_HEAD(&env_free_list, e, env_link);
-    LIST_REMOVE(e, env_sched_link);
+    TAILQ_INSERT_HEAD(&env_free_list, e, env_link);
 }
 
 /* Overview:
@@ -453,17 +561,13 @@ env_destroy(struct Env *e)
     /* Hint: schedule to run a new environment. */
 	if (curenv == e) {
 		curenv = NULL;
-        /* Hint:Why this? */
-		bcopy((void *)KERNEL_SP - sizeof(struct Trapframe),
-			  (void *)TIMESTACK - sizeof(struct Trapframe),
-			  sizeof(struct Trapframe));
 		printf("i am killed ... \n");
 		sched_yield();
 	}
 }
 
 extern void env_pop_tf(struct Trapframe *tf, int id);
-extern void lcontext(u_int contxt);
+extern void lcontext(u_int64_t satp);
 
 /* Overview:
  *  Restores the register values in the Trapframe with the
@@ -473,48 +577,42 @@ extern void lcontext(u_int contxt);
  *  Set 'e' as the curenv running environment.
  *
  * Hints:
- *  You may use these functions:
- *      env_pop_tf and lcontext.
+ *  The trap entry already saved curenv's registers into its env_tf
+ *  (sscratch points there while it runs), so nothing is copied here:
+ *  the switch is the curenv pointer, satp and the register restore.
+ *  The cycles spent in here are added to e->env_switch_cycles.
  */
 /*** exercise 3.10 ***/
 void
 env_run(struct Env *e)
 {
-    /*Step 1: save register state of curenv. */
-    /* Hint: if there is an environment running, you should do
-    *  switch the context and save the registers. You can imitate env_destroy() 's behaviors.*/
-//printf("env_run start!\n");
-    if (curenv != NULL) {
-        struct Trapframe *old;
-        old = (struct Trapframe *)(TIMESTACK - sizeof(struct Trapframe));
-//printf("env_run bcopy dest: %x\n", &(curenv->env_tf));
-        bcopy(old, &(curenv->env_tf), sizeof(struct Trapframe));
-//printf("env_run bcopy success!\n");
-        curenv->env_tf.pc = curenv->env_tf.epc;
-    }
+    u_int64_t start = get_cycle();
+    u_int hart = sched_this_hart();
 
-//printf("env_loaded\n");
-    /*Step 2: Set 'curenv' to the new environment. */
+    /*Step 1: Set 'curenv' to the new environment. */
     curenv = e;
+    curenv->env_runs++;
+    if (curenv->env_last_hart != hart) {
+        curenv->env_migrations++;
+        curenv->env_last_hart = hart;
+    }
+
+    /*Step 2: Use lcontext() to switch to its address space. */
+    lcontext(MAKE_SATP(MODE_SV39, PPN(curenv->env_cr3)));
 
-    /*Step 3: Use lcontext() to switch to its address space. */
-//printf("addr of e is : %08x\n", e);
-    lcontext(curenv->env_pgdir);
-//printf("%x context load succ!\n", curenv->env_id);
-    /*Step 4: Use env_pop_tf() to restore the environment's
-     * environment   registers and return to user mode.
-     *
-     * Hint: You should use GET_ENV_ASID there. Think why?
-     * (read <see mips run linux>, page 135-144)
+    /*Step 3: Use env_pop_tf() to restore the environment's
+     * registers and return to user mode.
      */
-//printf("Ready to pop tf!\n");
+    env_kdata_update(curenv);
+    curenv->env_exec_start = get_cycle();
+    curenv->env_switch_cycles += curenv->env_exec_start - start;
     env_pop_tf(&(curenv->env_tf), GET_ENV_ASID(curenv->env_id));
 }
 
 void env_check()
 {
         struct Env *temp, *pe, *pe0, *pe1, *pe2;
-        struct Env_list fl;
+        struct Env_tailq fl;
         int re = 0;
      // should be able to allocate three envs
     pe0 = 0;
@@ -531,7 +629,7 @@ void env_check()
      // temporarily steal the rest of the free envs
      fl = env_free_list;
     // now this env_free list must be empty!!!!
-    LIST_INIT(&env_free_list);
+    TAILQ_INIT(&env_free_list);
 
     // should be no free memory
      assert(env_alloc(&pe, 0) == -E_NO_FREE_ENV);
@@ -575,7 +673,7 @@ void env_check()
         printf("env_setup_vm passed!\n");
 
         assert(pe2->env_tf.sstatus == 0x10001004);
-        printf("pe2`s sp register %x\n",pe2->env_tf.regs[29]);
+        printf("pe2`s sp register %x\n",pe2->env_tf.regs[2]);
         printf("env_check() succeeded!\n");
 }
 
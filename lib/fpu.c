@@ -0,0 +1,86 @@
+#include <env.h>
+#include <fpu.h>
+#include <printf.h>
+
+struct Env *fpu_owner = NULL;	// env whose registers are in the FPU
+
+static struct Fpstate fp_zero;	// initial state of a fresh env
+
+/* Overview:
+ *  Take the FPU away from its owner. The registers are written back
+ *  only if the owner dirtied them since they were loaded.
+ */
+static void
+fpu_evict(void)
+{
+    struct Env *e = fpu_owner;
+
+    if (e == NULL) {
+        return;
+    }
+    if ((e->env_tf.sstatus & SSTATUS_FS) == SSTATUS_FS_DIRTY) {
+        fpu_save(&e->env_fp);
+        e->env_fp_used = 1;
+        e->env_fp_saves++;
+    }
+    e->env_tf.sstatus &= ~SSTATUS_FS;
+    fpu_owner = NULL;
+}
+
+/* Overview:
+ *  Illegal-instruction hook. If curenv hit an FP instruction with FS
+ *  Off, hand it the FPU and let the instruction restart.
+ *
+ * Post-Condition:
+ *  Return 1 if the trap was handled, 0 if it is a real illegal
+ *  instruction.
+ */
+int
+fpu_trap(struct Trapframe *tf)
+{
+    if (curenv == NULL || tf != &curenv->env_tf ||
+        (tf->sstatus & SSTATUS_FS) != SSTATUS_FS_OFF) {
+        return 0;
+    }
+    if (fpu_owner != curenv) {
+        fpu_evict();
+        fpu_restore(curenv->env_fp_used ? &curenv->env_fp : &fp_zero);
+        fpu_owner = curenv;
+    }
+    tf->sstatus |= SSTATUS_FS_CLEAN;
+    return 1;
+}
+
+/* Overview:
+ *  Give `child` a copy of `parent`'s FP state. The child does not own
+ *  the FPU, so it starts with FS Off.
+ */
+void
+fpu_fork(struct Env *parent, struct Env *child)
+{
+    if (fpu_owner == parent &&
+        (parent->env_tf.sstatus & SSTATUS_FS) == SSTATUS_FS_DIRTY) {
+        fpu_save(&parent->env_fp);
+        parent->env_fp_used = 1;
+        parent->env_fp_saves++;
+        parent->env_tf.sstatus = (parent->env_tf.sstatus & ~SSTATUS_FS) |
+                                 SSTATUS_FS_CLEAN;
+    }
+    child->env_fp_used = parent->env_fp_used;
+    if (child->env_fp_used) {
+        child->env_fp = parent->env_fp;
+    }
+    child->env_tf.sstatus &= ~SSTATUS_FS;
+}
+
+/* Overview:
+ *  Forget `e`'s FP registers; called when `e` is freed.
+ */
+void
+fpu_release(struct Env *e)
+{
+    if (fpu_owner == e) {
+        fpu_owner = NULL;
+    }
+    e->env_fp_used = 0;
+}
@@ -0,0 +1,170 @@
+#include <env.h>
+#include <futex.h>
+#include <pmap.h>
+#include <sched.h>
+#include <kclock.h>
+#include <error.h>
+
+/* Waiters hashed by physical page, so every env mapping a shared page
+ * meets on the same bucket whatever va it uses. */
+static struct Env_tailq futex_hash[FUTEX_BUCKETS];
+static u_int futex_ntimed;	// waiters with a timeout
+
+#define futex_bucket(pa)	(&futex_hash[((pa) >> PGSHIFT) & (FUTEX_BUCKETS - 1)])
+
+/* Overview:
+ *  Empty the wait buckets. Called by env_init, before any env exists.
+ */
+void
+futex_init(void)
+{
+    int i;
+
+    for (i = 0; i < FUTEX_BUCKETS; i++) {
+        TAILQ_INIT(&futex_hash[i]);
+    }
+}
+
+/* Overview:
+ *  Translate the word at `va` in `e` to its futex key, the physical
+ *  address, and to a kernel pointer *kva through which to read it.
+ *
+ * Post-Condition:
+ *  Return 0, or -E_INVAL if `va` is unaligned, above UTOP or unmapped.
+ */
+int
+futex_key(struct Env *e, u_int va, u_long *key, volatile u_int **kva)
+{
+    struct Page *pp;
+    Pte *pte;
+    u_int off = va & (BY2PG - 1);
+
+    if ((va & 3) != 0 || va >= UTOP) {
+        return -E_INVAL;
+    }
+    if ((pp = page_lookup(e->env_pgdir, va, &pte)) == NULL) {
+        return -E_INVAL;
+    }
+    *key = page2pa(pp) + off;
+    *kva = (volatile u_int *)(page2kva(pp) + off);
+    return 0;
+}
+
+static void
+futex_unqueue(struct Env *e)
+{
+    TAILQ_REMOVE(futex_bucket(e->env_futex_key), e, env_futex_link);
+    e->env_futex_key = 0;
+    if (e->env_futex_deadline != 0) {
+        e->env_futex_deadline = 0;
+        futex_ntimed--;
+    }
+}
+
+static void
+futex_wakeup(struct Env *e, int ret)
+{
+    futex_unqueue(e);
+    e->env_tf.regs[10] = ret;
+    e->env_status = ENV_RUNNABLE;
+    sched_enqueue(e);
+}
+
+/* Overview:
+ *  Block `e` on `key`, in FIFO order behind earlier waiters, for at
+ *  most `timeout` cycles (0 waits forever). The caller then yields;
+ *  `e` resumes with a0 = 0 when woken or -E_TIMEOUT.
+ */
+void
+futex_wait(struct Env *e, u_long key, u_int timeout)
+{
+    e->env_futex_key = key;
+    e->env_futex_deadline = 0;
+    if (timeout != 0) {
+        e->env_futex_deadline = get_cycle() + timeout;
+        futex_ntimed++;
+    }
+    TAILQ_INSERT_TAIL(futex_bucket(key), e, env_futex_link);
+    e->env_tf.regs[10] = 0;
+    e->env_status = ENV_NOT_RUNNABLE;
+    sched_dequeue(e);
+}
+
+/* Overview:
+ *  Wake up to `n` envs waiting on `key`, oldest first.
+ *
+ * Post-Condition:
+ *  Return the number woken.
+ */
+int
+futex_wake(u_long key, u_int n)
+{
+    struct Env *e, *next;
+    int woken = 0;
+
+    for (e = TAILQ_FIRST(futex_bucket(key)); e != NULL && woken < n;
+         e = next) {
+        next = TAILQ_NEXT(e, env_futex_link);
+        if (e->env_futex_key == key) {
+            futex_wakeup(e, 0);
+            woken++;
+        }
+    }
+    return woken;
+}
+
+/* Overview:
+ *  A mapping of the page at `pa` went away: wake everyone waiting on a
+ *  word in it, so waits that depend on page references (a pipe whose
+ *  other end closed) recheck. Their wait returns 0, like a wake.
+ */
+void
+futex_wake_page(u_long pa)
+{
+    struct Env *e, *next;
+
+    pa &= ~(u_long)(BY2PG - 1);
+    for (e = TAILQ_FIRST(futex_bucket(pa)); e != NULL; e = next) {
+        next = TAILQ_NEXT(e, env_futex_link);
+        if ((e->env_futex_key & ~(u_long)(BY2PG - 1)) == pa) {
+            futex_wakeup(e, 0);
+        }
+    }
+}
+
+/* Overview:
+ *  Fail the waits whose timeout has passed with -E_TIMEOUT. Called by
+ *  the scheduler; free when nobody waits with a timeout.
+ */
+void
+futex_expire(void)
+{
+    struct Env *e, *next;
+    u_int64_t now;
+    int i;
+
+    if (futex_ntimed == 0) {
+        return;
+    }
+    now = get_cycle();
+    for (i = 0; i < FUTEX_BUCKETS; i++) {
+        for (e = TAILQ_FIRST(&futex_hash[i]); e != NULL; e = next) {
+            next = TAILQ_NEXT(e, env_futex_link);
+            if (e->env_futex_deadline != 0 && now >= e->env_futex_deadline) {
+                futex_wakeup(e, -E_TIMEOUT);
+            }
+        }
+    }
+}
+
+/* Overview:
+ *  `e` is being freed: drop its wait, if any. Must run before its pages
+ *  are unmapped, so futex_wake_page does not wake it.
+ */
+void
+futex_exit(struct Env *e)
+{
+    if (e->env_futex_key != 0) {
+        futex_unqueue(e);
+    }
+}
@@ -0,0 +1,280 @@
+#include <env.h>
+#include <ipc.h>
+#include <notif.h>
+#include <endpoint.h>
+#include <sched.h>
+#include <error.h>
+#include <pmap.h>
+#include <printf.h>
+
+/* Overview:
+ *  Whether `to` is receiving and would take a message from `from`.
+ */
+int
+ipc_can_deliver(struct Env *from, struct Env *to)
+{
+    return to->env_ipc_recving &&
+           (to->env_ipc_recv_from == 0 ||
+            to->env_ipc_recv_from == from->env_id);
+}
+
+/* Overview:
+ *  Range `i` of the grant described by srcva/npages: the range itself,
+ *  or the i-th IPC_SEG word of `from`'s register message for a scatter
+ *  list (IPC_PAGES_SG).
+ *
+ * Post-Condition:
+ *  Return the number of ranges.
+ */
+static u_int
+ipc_seg(struct Env *from, u_int srcva, u_int npages, u_int i, u_long *va,
+        u_int *n)
+{
+    u_int nseg;
+    u_long w;
+
+    if (!(npages & IPC_PAGES_SG)) {
+        *va = ROUNDDOWN(srcva, BY2PG);
+        *n = npages;
+        return 1;
+    }
+    nseg = MIN(from->env_tf.regs[IPC_MR_LEN_REG], IPC_MR_WORDS);
+    if (i < nseg) {
+        w = from->env_tf.regs[IPC_MR_FIRST_REG + i];
+        *va = IPC_SEG_VA(w);
+        *n = IPC_SEG_N(w);
+    }
+    return nseg;
+}
+
+/* Overview:
+ *  Map the pages granted by `from` (see ipc_seg) back to back at
+ *  to->env_ipc_dstva with `perm`. Everything is checked, and `to`'s
+ *  page tables for the window allocated, before anything is mapped,
+ *  so a grant is mapped whole or not at all. The TLB is flushed once
+ *  for the lot.
+ *
+ * Post-Condition:
+ *  Return the number of pages mapped, -E_INVAL if a page is unmapped
+ *  in `from`, would become writable, or does not fit in `to`'s
+ *  window of env_ipc_dstpages, or -E_NO_MEM.
+ */
+static int
+ipc_map_pages(struct Env *from, struct Env *to, u_int srcva, u_int npages,
+              u_int perm)
+{
+    struct Page *pp;
+    Pte *pte;
+    u_long va, dst;
+    u_int i, j, n, nseg, total = 0;
+    int r;
+
+    nseg = ipc_seg(from, srcva, npages, 0, &va, &n);
+    for (i = 0; i < nseg; i++) {
+        ipc_seg(from, srcva, npages, i, &va, &n);
+        if (va >= UTOP || n > (UTOP - va) / BY2PG) {
+            return -E_INVAL;
+        }
+        for (j = 0; j < n; j++) {
+            pp = page_lookup(from->env_pgdir, va + j * BY2PG, &pte);
+            if (pp == NULL || ((*pte & PTE_R) == 0 && (perm & PTE_R))) {
+                return -E_INVAL;
+            }
+        }
+        total += n;
+    }
+    if (total > to->env_ipc_dstpages) {
+        return -E_INVAL;
+    }
+    // with its page tables in place page_insert cannot fail below
+    for (i = 0, dst = to->env_ipc_dstva; i < total; i++, dst += BY2PG) {
+        if ((r = vpt2_walk(to->env_pgdir, dst, 1, &pte)) < 0) {
+            return r;
+        }
+    }
+
+    dst = to->env_ipc_dstva;
+    tlb_batch_begin();
+    for (i = 0; i < nseg; i++) {
+        ipc_seg(from, srcva, npages, i, &va, &n);
+        for (j = 0; j < n; j++, dst += BY2PG) {
+            pp = page_lookup(from->env_pgdir, va + j * BY2PG, &pte);
+            page_insert_batch(to->env_pgdir, pp, dst, perm | PTE_V);
+        }
+    }
+    tlb_batch_end();
+    return total;
+}
+
+/* Overview:
+ *  Hand one message from `from` to the receiving env `to` and make `to`
+ *  runnable again. If srcva != 0, the `npages` pages from srcva in
+ *  `from` (or, for IPC_PAGES_SG, the ranges of its scatter list) are
+ *  mapped at to->env_ipc_dstva. The message is also left in `to`'s saved
+ *  registers: a0 = 0, a1 = value, a2 = sender. The register message
+ *  words the sender passed are copied to to->env_ipc_mr. A notification
+ *  wait `to` was making alongside the receive is abandoned.
+ *
+ * Pre-Condition:
+ *  `to` is blocked in sys_ipc_recv (env_ipc_recving is set).
+ *
+ * Post-Condition:
+ *  Return 0 on success, or the ipc_map_pages error. `to` is woken either
+ *  way.
+ */
+int
+ipc_deliver(struct Env *from, struct Env *to, u_int value, u_int srcva,
+            u_int npages, u_int perm)
+{
+    int r = 0;
+    u_int i, n;
+
+    to->env_ipc_recving = 0;
+    to->env_ipc_recv_from = 0;
+    sched_pi_unwait(to);
+    notif_cancel(to);
+    ep_unwait(to);
+    to->env_ipc_from = from->env_id;
+    to->env_ipc_value = value;
+    to->env_ipc_perm = 0;
+    to->env_ipc_npages = 0;
+    to->env_tf.regs[10] = 0;
+    to->env_tf.regs[11] = value;
+    to->env_tf.regs[12] = from->env_id;
+
+    n = from->env_tf.regs[IPC_MR_LEN_REG];
+    if (n > IPC_MR_WORDS) {
+        n = IPC_MR_WORDS;
+    }
+    for (i = 0; i < n; i++) {
+        to->env_ipc_mr[i] = from->env_tf.regs[IPC_MR_FIRST_REG + i];
+    }
+    to->env_ipc_mr_len = n;
+    to->env_status = ENV_RUNNABLE;
+    sched_enqueue(to);
+
+    if (srcva != 0 || (npages & IPC_PAGES_SG)) {
+        r = ipc_map_pages(from, to, srcva, npages, perm);
+        if (r >= 0) {
+            to->env_ipc_perm = perm;
+            to->env_ipc_npages = r;
+            r = 0;
+        }
+    }
+    to->env_ipc_dstpages = 1;
+    return r;
+}
+
+/* Overview:
+ *  Block `from` on the FIFO of senders waiting for `to` to receive. The
+ *  message is kept in `from` until ipc_complete_sender() delivers it.
+ *  While queued, `from` lends `to` its priority.
+ */
+void
+ipc_queue_sender(struct Env *from, struct Env *to, u_int value, u_int srcva,
+                 u_int npages, u_int perm)
+{
+    from->env_ipc_send_to = to;
+    from->env_ipc_send_value = value;
+    from->env_ipc_send_srcva = srcva;
+    from->env_ipc_send_npages = npages;
+    from->env_ipc_send_perm = perm;
+    TAILQ_INSERT_TAIL(&to->env_ipc_senders, from, env_ipc_send_link);
+    from->env_status = ENV_NOT_RUNNABLE;
+    sched_dequeue(from);
+    sched_pi_wait(from, to);
+}
+
+/* Overview:
+ *  Block `e` until `server` replies: a receive that only `server` can
+ *  complete, lending `server` e's priority meanwhile. Replies carry no
+ *  page unless e->env_ipc_dstva was set by the caller.
+ */
+void
+ipc_wait_reply(struct Env *e, struct Env *server)
+{
+    e->env_ipc_recving = 1;
+    e->env_ipc_recv_from = server->env_id;
+    e->env_status = ENV_NOT_RUNNABLE;
+    sched_dequeue(e);
+    sched_pi_wait(e, server);
+}
+
+/* Overview:
+ *  `to` has just started receiving: deliver the message of the sender
+ *  that has waited longest (among those `to` accepts), or else of the
+ *  oldest caller of the endpoint `to` serves, and wake that sender,
+ *  whose ipc_send then returns the delivery result. A sender that was
+ *  making an ipc_call stays blocked, now waiting for the reply.
+ *
+ * Post-Condition:
+ *  Return the sender, or NULL if no acceptable one was waiting.
+ */
+struct Env *
+ipc_complete_sender(struct Env *to)
+{
+    struct Env *from;
+    int r;
+
+    TAILQ_FOREACH(from, &to->env_ipc_senders, env_ipc_send_link) {
+        if (ipc_can_deliver(from, to)) {
+            break;
+        }
+    }
+    if (from != NULL) {
+        TAILQ_REMOVE(&to->env_ipc_senders, from, env_ipc_send_link);
+        from->env_ipc_send_to = NULL;
+        sched_pi_unwait(from);
+    } else if ((from = ep_take_sender(to)) == NULL) {
+        return NULL;
+    }
+    r = ipc_deliver(from, to, from->env_ipc_send_value,
+                    from->env_ipc_send_srcva, from->env_ipc_send_npages,
+                    from->env_ipc_send_perm);
+    if (from->env_ipc_calling && r == 0) {
+        from->env_ipc_calling = 0;
+        ipc_wait_reply(from, to);
+        return from;
+    }
+    from->env_ipc_calling = 0;
+    from->env_tf.regs[10] = r;
+    from->env_status = ENV_RUNNABLE;
+    sched_enqueue(from);
+    return from;
+}
+
+/* Overview:
+ *  `e` is being freed: take it off the queue it is blocked on, and fail
+ *  the sends still queued on it, and the calls waiting for its reply,
+ *  with -E_BAD_ENV.
+ */
+void
+ipc_exit(struct Env *e)
+{
+    struct Env *from, *next;
+
+    for (from = LIST_FIRST(&e->env_pi_waiters); from != NULL; from = next) {
+        next = LIST_NEXT(from, env_pi_link);
+        if (from->env_ipc_recving && from->env_ipc_recv_from == e->env_id) {
+            from->env_ipc_recving = 0;
+            from->env_ipc_recv_from = 0;
+            from->env_tf.regs[10] = -E_BAD_ENV;
+            from->env_status = ENV_RUNNABLE;
+            sched_enqueue(from);
+        }
+    }
+
+    if (e->env_ipc_send_to != NULL) {
+        TAILQ_REMOVE(&e->env_ipc_send_to->env_ipc_senders, e,
+                     env_ipc_send_link);
+        e->env_ipc_send_to = NULL;
+    }
+    while ((from = TAILQ_FIRST(&e->env_ipc_senders)) != NULL) {
+        TAILQ_REMOVE(&e->env_ipc_senders, from, env_ipc_send_link);
+        from->env_ipc_send_to = NULL;
+        from->env_ipc_calling = 0;
+        from->env_tf.regs[10] = -E_BAD_ENV;
+        from->env_status = ENV_RUNNABLE;
+        sched_enqueue(from);
+    }
+}
@@ -1,8 +1,6 @@
 /* The run time clock is hard-wired to IRQ8. */
 #include <kclock.h>
-
-
-extern void set_timer();
+#include <trap.h>
 
 //Overview:
 //Use function set_timer to initialize clock interrupt.
@@ -17,6 +15,9 @@ extern void set_timer();
 void
 kclock_init(void)
 {
-        /* initialize 8253 clock to interrupt 100 times/sec */
+        /* let user mode read cycle/time/instret for its own accounting */
+        asm volatile("csrw scounteren, %0" : : "r"(0x7));
+        /* interrupt 100 times/sec; do_int_timer re-arms it */
         set_timer();
+        asm volatile("csrs sie, %0" : : "r"(SIE_STIE));
 }
@@ -0,0 +1,120 @@
+#include <klog.h>
+#include <print.h>
+#include <printf.h>
+#include <cons.h>
+
+/* The log is a byte ring of records, each a level byte (level + 1, so
+ * never a NUL), the formatted text and a NUL. Indices count bytes ever
+ * written and wrap at 2^32; a writer just overwrites the oldest
+ * records. */
+static char klog_buf[KLOG_SIZE];
+static u_int klog_tail;		// next byte to write
+static u_int klog_seen;		// next byte klog_flush looks at
+
+int klog_console = KLOG_INFO;
+
+static void
+klog_putc(char c)
+{
+    klog_buf[klog_tail++ & KLOG_MASK] = c;
+}
+
+static void
+klog_output(void *arg, char *s, int l)
+{
+    int i;
+
+    for (i = 0; i < l; i++) {
+        if (s[i] != '\0') {
+            klog_putc(s[i]);
+        }
+    }
+}
+
+/* Overview:
+ *  Oldest index at or after `from` that starts a whole record.
+ */
+static u_int
+klog_first(u_int from)
+{
+    if (klog_tail - from <= KLOG_SIZE) {
+        return from;
+    }
+    // the record under the new oldest byte was partly overwritten
+    from = klog_tail - KLOG_SIZE;
+    while (from != klog_tail && klog_buf[from++ & KLOG_MASK] != '\0')
+        ;
+    return from;
+}
+
+/* Overview:
+ *  Append a record to the log. Nothing is printed here unless the
+ *  record is a warning or worse; the rest reach the console when
+ *  klog_flush next runs.
+ */
+void
+klog(int level, char *fmt, ...)
+{
+    va_list ap;
+
+    klog_putc(level + 1);
+    va_start(ap, fmt);
+    lp_Print(klog_output, 0, fmt, ap);
+    va_end(ap);
+    klog_putc('\0');
+
+    if (level <= KLOG_WARN) {
+        klog_flush();
+    }
+}
+
+/* Overview:
+ *  Print the records logged since the last call whose level is at most
+ *  klog_console. Cheap when there is nothing new, so it can sit on the
+ *  printf and idle paths.
+ */
+void
+klog_flush(void)
+{
+    u_int i;
+    int show;
+    char c;
+
+    if (klog_seen == klog_tail) {
+        return;
+    }
+    i = klog_first(klog_seen);
+    while (i != klog_tail) {
+        show = klog_buf[i++ & KLOG_MASK] - 1 <= klog_console;
+        while (i != klog_tail && (c = klog_buf[i++ & KLOG_MASK]) != '\0') {
+            if (show) {
+                cons_putc(c);
+            }
+        }
+    }
+    klog_seen = klog_tail;
+    cons_flush();
+}
+
+/* Overview:
+ *  Print every record still in the ring, debug ones included; called
+ *  on panic.
+ */
+void
+klog_dump(void)
+{
+    u_int i;
+    char c;
+
+    klog_flush();
+    cons_write("---- klog ----\n", 15);
+    i = klog_first(0);
+    while (i != klog_tail) {
+        i++;		// level
+        while (i != klog_tail && (c = klog_buf[i++ & KLOG_MASK]) != '\0') {
+            cons_putc(c);
+        }
+    }
+    cons_write("---- end klog ----\n", 19);
+    cons_flush();
+}
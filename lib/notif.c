@@ -0,0 +1,149 @@
+#include <env.h>
+#include <notif.h>
+#include <sched.h>
+#include <endpoint.h>
+#include <error.h>
+
+static struct Notif notifs[NNOTIF];
+static u_int notif_gen;
+
+/* Overview:
+ *  Take a free notification object for `owner` and return its id in *id.
+ *  Ids carry a generation above the slot index, so a stale id does not
+ *  name a reused slot.
+ *
+ * Post-Condition:
+ *  Return 0 on success, -E_NO_MEM if all NNOTIF objects are in use.
+ */
+int
+notif_alloc(struct Env *owner, u_int *id)
+{
+    struct Notif *n;
+    int i;
+
+    for (i = 0; i < NNOTIF; i++) {
+        n = &notifs[i];
+        if (n->n_id == 0) {
+            n->n_id = (++notif_gen * NNOTIF) | i;
+            if (n->n_id == 0) {
+                n->n_id = (++notif_gen * NNOTIF) | i;
+            }
+            n->n_owner = owner->env_id;
+            n->n_bits = 0;
+            n->n_waiter = NULL;
+            *id = n->n_id;
+            return 0;
+        }
+    }
+    return -E_NO_MEM;
+}
+
+/* Overview:
+ *  Find the live notification object named by `id`.
+ *
+ * Post-Condition:
+ *  Return 0 and set *n, or -E_INVAL if `id` is stale or never existed.
+ */
+int
+notif_lookup(u_int id, struct Notif **n)
+{
+    struct Notif *p = &notifs[NOTIFX(id)];
+
+    if (id == 0 || p->n_id != id) {
+        return -E_INVAL;
+    }
+    *n = p;
+    return 0;
+}
+
+/* Overview:
+ *  Release `n`. Its owner must not be waiting on it.
+ */
+void
+notif_free(struct Notif *n)
+{
+    n->n_id = 0;
+    n->n_owner = 0;
+    n->n_bits = 0;
+    n->n_waiter = NULL;
+}
+
+/* Overview:
+ *  Set `bits` in `n`. Never blocks. If the owner is waiting, it takes
+ *  every pending bit and wakes with NOTIF_WOKEN in a0; otherwise the
+ *  bits accumulate, so many signals cost the owner a single wakeup.
+ */
+void
+notif_signal(struct Notif *n, u_int bits)
+{
+    struct Env *e = n->n_waiter;
+
+    n->n_bits |= bits;
+    if (e == NULL || n->n_bits == 0) {
+        return;
+    }
+    n->n_waiter = NULL;
+    e->env_notif_wait = NULL;
+    e->env_notif_bits = n->n_bits;
+    n->n_bits = 0;
+    if (e->env_ipc_recving) {
+        /* It was also receiving: the notification wins. */
+        e->env_ipc_recving = 0;
+        e->env_ipc_recv_from = 0;
+        sched_pi_unwait(e);
+        ep_unwait(e);
+    }
+    e->env_tf.regs[10] = NOTIF_WOKEN;
+    e->env_status = ENV_RUNNABLE;
+    sched_enqueue(e);
+}
+
+/* Overview:
+ *  `e` waits on `n`. Pending bits are taken at once into
+ *  e->env_notif_bits; otherwise `e` is recorded as the waiter, and the
+ *  caller is to block it.
+ *
+ * Post-Condition:
+ *  Return 1 if bits were taken, 0 if `e` must block.
+ */
+int
+notif_wait(struct Env *e, struct Notif *n)
+{
+    if (n->n_bits != 0) {
+        e->env_notif_bits = n->n_bits;
+        n->n_bits = 0;
+        return 1;
+    }
+    n->n_waiter = e;
+    e->env_notif_wait = n;
+    return 0;
+}
+
+/* Overview:
+ *  Stop `e` waiting on its notification object, if any; an IPC message
+ *  woke it first.
+ */
+void
+notif_cancel(struct Env *e)
+{
+    if (e->env_notif_wait != NULL) {
+        e->env_notif_wait->n_waiter = NULL;
+        e->env_notif_wait = NULL;
+    }
+}
+
+/* Overview:
+ *  `e` is being freed: stop its wait and free the objects it owns.
+ */
+void
+notif_exit(struct Env *e)
+{
+    int i;
+
+    notif_cancel(e);
+    for (i = 0; i < NNOTIF; i++) {
+        if (notifs[i].n_id != 0 && notifs[i].n_owner == e->env_id) {
+            notif_free(&notifs[i]);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#include <plic.h>
+#include <cons.h>
+#include <sched.h>
+#include <printf.h>
+
+#define plic_reg(a)	(*(volatile u_int *)(u_long)(a))
+
+/* Overview:
+ *  Accept interrupts of any non-zero priority on this hart's S-mode
+ *  context and let external interrupts in.
+ */
+void
+plic_init(void)
+{
+    plic_reg(PLIC_STHRESHOLD(sched_this_hart())) = 0;
+    asm volatile("csrs sie, %0" : : "r"(SIE_SEIE));
+}
+
+/* Overview:
+ *  Route source `irq` to this hart's S-mode context.
+ */
+void
+plic_enable(u_int irq)
+{
+    plic_reg(PLIC_PRIORITY(irq)) = 1;
+    plic_reg(PLIC_SENABLE(sched_this_hart()) + 4 * (irq / 32)) |= 1 << (irq % 32);
+}
+
+/* Overview:
+ *  External interrupt: claim and serve every pending source. If that
+ *  woke an env and we interrupted user mode, reschedule at once so the
+ *  woken env does not wait for the running one to trap.
+ */
+void
+plic_intr(struct Trapframe *tf)
+{
+    u_int hart = sched_this_hart();
+    u_int irq;
+    int woken = 0;
+
+    while ((irq = plic_reg(PLIC_SCLAIM(hart))) != 0) {
+        if (irq == UART0_IRQ) {
+            woken += cons_intr();
+        } else {
+            printf("plic: spurious irq %d\n", irq);
+        }
+        plic_reg(PLIC_SCLAIM(hart)) = irq;
+    }
+    if (woken && curenv != NULL && tf == &curenv->env_tf) {
+        sched_yield();
+    }
+}
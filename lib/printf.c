@@ -13,6 +13,8 @@
 #include <print.h>
 //#include <drivers/gxconsole/dev_cons.h>
 #include <sbilib_mos.h>
+#include <cons.h>
+#include <klog.h>
 
 static void myoutput(void *arg, char *s, int l)
 {
@@ -24,10 +26,10 @@ static void myoutput(void *arg, char *s, int l)
 	}
 
 	for (i = 0; i < l; i++) {
-		sbi_console_putchar(s[i]);
+		cons_putc(s[i]);
 
 		if (s[i] == '\n') {
-			sbi_console_putchar('\n');
+			cons_putc('\n');
 		}
 	}
 }
@@ -35,9 +37,11 @@ static void myoutput(void *arg, char *s, int l)
 void printf(char *fmt, ...)
 {
 	va_list ap;
+	klog_flush();		/* keep earlier log records in order */
 	va_start(ap, fmt);
 	lp_Print(myoutput, 0, fmt, ap);
 	va_end(ap);
+	cons_flush();
 }
 
 void
@@ -49,8 +53,9 @@ _panic(const char *file, int line, const char *fmt, ...)
 	va_start(ap, fmt);
 	printf("panic at %s:%d: ", file, line);
 	lp_Print(myoutput, 0, (char *)fmt, ap);
-	printf("\n");
+	printf("\n");		/* flushes the message too */
 	va_end(ap);
+	klog_dump();
 
 
 	for (;;);
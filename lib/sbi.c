@@ -12,3 +12,26 @@
 void sbi_console_putchar(unsigned char ch) {
 	sys_ecall(SBI_CONSOLE_PUTCHAR, ch, 0, 0);
 }
+
+/* Overview:
+ *  Write up to `n` bytes at `buf` with one DBCN call. The kernel is
+ *  identity mapped, so `buf` is also the physical address SBI wants.
+ *
+ * Post-Condition:
+ *  Return the number of bytes written, or -1 if the firmware has no
+ *  debug console extension (checked once).
+ */
+long sbi_debug_console_write(const char *buf, u_long n) {
+	static int dbcn = -1;	// unknown yet
+	struct sbiret r;
+
+	if (dbcn < 0) {
+		r = sbi_call(SBI_EXT_BASE, SBI_BASE_PROBE_EXT, SBI_EXT_DBCN, 0, 0);
+		dbcn = r.error == 0 && r.value != 0;
+	}
+	if (!dbcn) {
+		return -1;
+	}
+	r = sbi_call(SBI_EXT_DBCN, SBI_DBCN_WRITE, n, (u_long)buf, 0);
+	return r.error == 0 ? r.value : -1;
+}
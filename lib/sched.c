@@ -1,60 +1,730 @@
 #include <env.h>
 #include <pmap.h>
 #include <printf.h>
+#include <error.h>
+#include <sched.h>
+#include <kclock.h>
+#include <futex.h>
+#include <klog.h>
+
+/* Runnable SCHED_FAIR envs, kept as a binary min-heap on env_vruntime. */
+static struct Env *fair_heap[NENV];
+static int fair_nr = 0;
+static u_int64_t fair_min_vruntime = 0;	// never decreases
+static struct Env *fair_skip = NULL;	// passed over by the next pick
+
+static int rr_count = 0;	// remaining time slices of current RR env
+static int rr_point = 0;	// current env_sched_list index
+
+/* Runnable SCHED_EDF envs sorted by env_dl_abs, and those that spent
+ * their budget and wait for the next period. */
+static struct Env_list edf_list = LIST_HEAD_INITIALIZER(edf_list);
+static struct Env_list edf_throttled = LIST_HEAD_INITIALIZER(edf_throttled);
+static u_int edf_total_bw = 0;
+
+int sched_need_resched = 0;	// a better env woke up; reschedule on return
+u_int sched_dl_lat_hist[SCHED_LAT_BUCKETS];
+
+static inline u_int64_t
+fair_weight(struct Env *e)
+{
+    u_int pri = sched_eff_pri(e);
+
+    return pri ? pri : 1;
+}
+
+static void
+fair_swap(int i, int j)
+{
+    struct Env *t = fair_heap[i];
+
+    fair_heap[i] = fair_heap[j];
+    fair_heap[j] = t;
+    fair_heap[i]->env_heap_idx = i;
+    fair_heap[j]->env_heap_idx = j;
+}
+
+static void
+fair_sift_up(int i)
+{
+    int parent;
+
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (fair_heap[parent]->env_vruntime <= fair_heap[i]->env_vruntime) {
+            break;
+        }
+        fair_swap(i, parent);
+        i = parent;
+    }
+}
+
+static void
+fair_sift_down(int i)
+{
+    int l, r, min;
+
+    for (;;) {
+        l = 2 * i + 1;
+        r = l + 1;
+        min = i;
+        if (l < fair_nr && fair_heap[l]->env_vruntime < fair_heap[min]->env_vruntime) {
+            min = l;
+        }
+        if (r < fair_nr && fair_heap[r]->env_vruntime < fair_heap[min]->env_vruntime) {
+            min = r;
+        }
+        if (min == i) {
+            break;
+        }
+        fair_swap(i, min);
+        i = min;
+    }
+}
+
+static void
+fair_update_min(void)
+{
+    if (fair_nr > 0 && fair_heap[0]->env_vruntime > fair_min_vruntime) {
+        fair_min_vruntime = fair_heap[0]->env_vruntime;
+    }
+}
+
+/* Overview:
+ *  Insert `e` into the fair heap. A waking env is placed no further back
+ *  than SCHED_FAIR_WAKEUP_CREDIT behind the current minimum, so sleeping
+ *  does not bank an unbounded claim on the cpu.
+ */
+static void
+fair_enqueue(struct Env *e)
+{
+    u_int64_t floor = 0;
+
+    if (fair_min_vruntime > SCHED_FAIR_WAKEUP_CREDIT) {
+        floor = fair_min_vruntime - SCHED_FAIR_WAKEUP_CREDIT;
+    }
+    if (e->env_vruntime < floor) {
+        e->env_vruntime = floor;
+    }
+    e->env_heap_idx = fair_nr;
+    fair_heap[fair_nr++] = e;
+    fair_sift_up(e->env_heap_idx);
+}
+
+static void
+fair_dequeue(struct Env *e)
+{
+    int i = e->env_heap_idx;
+
+    if (--fair_nr != i) {
+        fair_heap[i] = fair_heap[fair_nr];
+        fair_heap[i]->env_heap_idx = i;
+        fair_sift_down(i);
+        fair_sift_up(fair_heap[i]->env_heap_idx);
+    }
+    e->env_heap_idx = -1;
+    if (fair_skip == e) {
+        fair_skip = NULL;
+    }
+}
+
+/* Overview:
+ *  Slow path of fair_pick when the heap top is pinned elsewhere: the
+ *  allowed env with the smallest virtual runtime, the yielder last.
+ */
+static struct Env *
+fair_scan(void)
+{
+    struct Env *e, *best = NULL;
+    int i;
+
+    for (i = 0; i < fair_nr; i++) {
+        e = fair_heap[i];
+        if (!sched_allowed(e) || e == fair_skip) {
+            continue;
+        }
+        if (best == NULL || e->env_vruntime < best->env_vruntime) {
+            best = e;
+        }
+    }
+    if (best == NULL && fair_skip != NULL && fair_skip->env_on_rq &&
+        sched_allowed(fair_skip)) {
+        best = fair_skip;
+    }
+    return best;
+}
 
 /* Overview:
- *  Implement simple round-robin scheduling.
- *  Search through 'envs' for a runnable environment ,
- *  in circular fashion statrting after the previously running env,
- *  and switch to the first such environment found.
+ *  Return the runnable fair env with the smallest virtual runtime. If that
+ *  env asked to be skipped (it yielded), take the smaller of its children.
+ */
+static struct Env *
+fair_pick(void)
+{
+    struct Env *e;
+
+    if (fair_nr == 0) {
+        return NULL;
+    }
+    e = fair_heap[0];
+    if (e == fair_skip && fair_nr > 1) {
+        e = fair_heap[1];
+        if (fair_nr > 2 && fair_heap[2]->env_vruntime < e->env_vruntime) {
+            e = fair_heap[2];
+        }
+    }
+    if (!sched_allowed(e)) {
+        e = fair_scan();
+    }
+    fair_skip = NULL;
+    return e;
+}
+
+/* Overview:
+ *  Round-robin pick for SCHED_RR envs: the current env keeps the cpu for
+ *  env_pri consecutive calls, then moves to the tail of the other list.
+ */
+static struct Env *
+rr_pick(void)
+{
+    struct Env *e = curenv;
+    int i;
+
+    if (e != NULL && e->env_sched_class == SCHED_RR && e->env_on_rq) {
+        if (--rr_count > 0 && sched_allowed(e)) {
+            return e;
+        }
+        TAILQ_REMOVE(&env_sched_list[e->env_rr_list], e, env_sched_link);
+        e->env_rr_list = 1 - rr_point;
+        TAILQ_INSERT_TAIL(&env_sched_list[e->env_rr_list], e, env_sched_link);
+    }
+    for (i = 0; i < 2; i++) {
+        TAILQ_FOREACH(e, &env_sched_list[rr_point], env_sched_link) {
+            if (e->env_status == ENV_RUNNABLE && sched_allowed(e)) {
+                rr_count = sched_eff_pri(e);
+                return e;
+            }
+        }
+        rr_point = 1 - rr_point;
+    }
+    return NULL;
+}
+
+static void
+edf_insert(struct Env *e)
+{
+    struct Env *p, *last = NULL;
+
+    LIST_FOREACH(p, &edf_list, env_dl_link) {
+        if (e->env_dl_abs < p->env_dl_abs) {
+            LIST_INSERT_BEFORE(p, e, env_dl_link);
+            return;
+        }
+        last = p;
+    }
+    if (last == NULL) {
+        LIST_INSERT_HEAD(&edf_list, e, env_dl_link);
+    } else {
+        LIST_INSERT_AFTER(last, e, env_dl_link);
+    }
+}
+
+/* Overview:
+ *  Start a new period for `e` at cycle `start`: refill the budget and
+ *  move the absolute deadline.
+ */
+static void
+edf_new_period(struct Env *e, u_int64_t start)
+{
+    e->env_dl_abs = start + e->env_dl_deadline;
+    e->env_dl_next = start + e->env_dl_period;
+    e->env_dl_budget = e->env_dl_runtime;
+}
+
+static void
+edf_enqueue(struct Env *e)
+{
+    u_int64_t now = get_cycle();
+
+    // A wakeup past the current deadline or period starts afresh;
+    // otherwise the env keeps what is left of its budget.
+    if (now >= e->env_dl_abs || now >= e->env_dl_next) {
+        edf_new_period(e, now);
+    }
+    e->env_dl_wakeup = now;
+    if (e->env_dl_budget == 0) {
+        e->env_dl_throttled = 1;
+        LIST_INSERT_HEAD(&edf_throttled, e, env_dl_link);
+        return;
+    }
+    edf_insert(e);
+    if (curenv == NULL || curenv->env_sched_class != SCHED_EDF ||
+        curenv->env_dl_abs > e->env_dl_abs) {
+        sched_need_resched = 1;
+    }
+}
+
+static void
+edf_dequeue(struct Env *e)
+{
+    LIST_REMOVE(e, env_dl_link);
+    e->env_dl_throttled = 0;
+}
+
+/* Overview:
+ *  Move every throttled env whose next period has begun back onto the
+ *  edf runqueue with a full budget.
+ */
+static void
+edf_replenish(void)
+{
+    struct Env *e, *next;
+    u_int64_t now = get_cycle();
+
+    for (e = LIST_FIRST(&edf_throttled); e != NULL; e = next) {
+        next = LIST_NEXT(e, env_dl_link);
+        if (now < e->env_dl_next) {
+            continue;
+        }
+        LIST_REMOVE(e, env_dl_link);
+        e->env_dl_throttled = 0;
+        edf_new_period(e, now);
+        edf_insert(e);
+    }
+}
+
+static int
+lat_bucket(u_int64_t delay)
+{
+    int i = 0;
+
+    while (delay > 1 && i < SCHED_LAT_BUCKETS - 1) {
+        delay >>= 1;
+        i++;
+    }
+    return i;
+}
+
+/* Overview:
+ *  Return the edf env with the earliest deadline, recording its
+ *  wakeup-to-run delay the first time it is picked after waking.
+ */
+static struct Env *
+edf_pick(void)
+{
+    struct Env *e;
+
+    LIST_FOREACH(e, &edf_list, env_dl_link) {
+        if (sched_allowed(e)) {
+            break;
+        }
+    }
+    if (e != NULL && e->env_dl_wakeup != 0) {
+        sched_dl_lat_hist[lat_bucket(get_cycle() - e->env_dl_wakeup)]++;
+        e->env_dl_wakeup = 0;
+    }
+    return e;
+}
+
+/* Overview:
+ *  Put `e` on the runqueue of its scheduling class. Calling it for an env
+ *  that is already queued does nothing.
+ */
+void
+sched_enqueue(struct Env *e)
+{
+    if (e->env_on_rq) {
+        return;
+    }
+    if (e->env_sched_class == SCHED_EDF) {
+        edf_enqueue(e);
+    } else if (e->env_sched_class == SCHED_RR) {
+        e->env_rr_list = rr_point;
+        TAILQ_INSERT_TAIL(&env_sched_list[rr_point], e, env_sched_link);
+    } else {
+        fair_enqueue(e);
+    }
+    e->env_on_rq = 1;
+}
+
+/* Overview:
+ *  Take `e` off its class runqueue (it blocked, or is being freed).
+ */
+void
+sched_dequeue(struct Env *e)
+{
+    if (!e->env_on_rq) {
+        return;
+    }
+    if (e->env_sched_class == SCHED_EDF) {
+        edf_dequeue(e);
+    } else if (e->env_sched_class == SCHED_RR) {
+        TAILQ_REMOVE(&env_sched_list[e->env_rr_list], e, env_sched_link);
+    } else {
+        fair_dequeue(e);
+    }
+    e->env_on_rq = 0;
+}
+
+/* Overview:
+ *  Move `e` to scheduling class `class`, requeueing it if it is runnable.
+ *  Leaving SCHED_EDF gives back the env's reserved bandwidth; entering it
+ *  goes through sched_set_deadline instead.
  *
- * Hints:
- *  The variable which is for counting should be defined as 'static'.
+ * Post-Condition:
+ *  return 0 on success, -E_INVAL if `class` is unknown.
  */
-void sched_yield(void)
+int
+sched_set_class(struct Env *e, u_int class)
+{
+    u_int queued = e->env_on_rq;
+
+    if (class != SCHED_FAIR && class != SCHED_RR) {
+        return -E_INVAL;
+    }
+    sched_dequeue(e);
+    if (e->env_sched_class == SCHED_EDF) {
+        edf_total_bw -= e->env_dl_bw;
+        e->env_dl_bw = 0;
+    }
+    if (class == SCHED_FAIR && e->env_sched_class != SCHED_FAIR) {
+        e->env_vruntime = fair_min_vruntime;
+    }
+    e->env_sched_class = class;
+    if (queued) {
+        sched_enqueue(e);
+    }
+    return 0;
+}
+
+/* Overview:
+ *  Reserve `runtime` cycles out of every `period` for `e`, to be used
+ *  within `deadline` cycles of each period start, and move `e` to
+ *  SCHED_EDF. A `deadline` of 0 means the end of the period.
+ *
+ * Post-Condition:
+ *  return 0 on success.
+ *  return -E_INVAL unless 0 < runtime <= deadline <= period.
+ *  return -E_NO_BANDWIDTH if the reservation does not fit next to the
+ *  ones already admitted.
+ */
+int
+sched_set_deadline(struct Env *e, u_int64_t runtime, u_int64_t period,
+                   u_int64_t deadline)
+{
+    u_int queued = e->env_on_rq;
+    u_int old_bw, bw;
+
+    if (deadline == 0) {
+        deadline = period;
+    }
+    if (runtime == 0 || runtime > deadline || deadline > period) {
+        return -E_INVAL;
+    }
+    bw = (runtime << SCHED_DL_BW_SHIFT) / period;
+    old_bw = e->env_sched_class == SCHED_EDF ? e->env_dl_bw : 0;
+    if (edf_total_bw - old_bw + bw > SCHED_DL_BW_LIMIT) {
+        return -E_NO_BANDWIDTH;
+    }
+
+    sched_dequeue(e);
+    edf_total_bw = edf_total_bw - old_bw + bw;
+    e->env_sched_class = SCHED_EDF;
+    e->env_dl_bw = bw;
+    e->env_dl_runtime = runtime;
+    e->env_dl_period = period;
+    e->env_dl_deadline = deadline;
+    edf_new_period(e, get_cycle());
+    if (queued) {
+        sched_enqueue(e);
+    }
+    return 0;
+}
+
+/* Overview:
+ *  Drop `e` from the scheduler for good: dequeue it and release any
+ *  deadline bandwidth it holds. Called when the env is freed.
+ */
+void
+sched_exit(struct Env *e)
 {
-    static int count = 0; // remaining time slices of current env
-    static int point = 0; // current env_sched_list index
-//u_int *addr = 0x0040500c;
-//printf("\nsch_start\n");
-    /*  hint:
-     *  1. if (count==0), insert `e` into `env_sched_list[1-point]`
-     *     using LIST_REMOVE and LIST_INSERT_TAIL.
-     *  2. if (env_sched_list[point] is empty), point = 1 - point;
-     *     then search through `env_sched_list[point]` for a runnable env `e`,
-     *     and set count = e->env_pri
-     *  3. count--
-     *  4. env_run()
-     *
-     *  functions or macros below may be used (not all):
-     *  LIST_INSERT_TAIL, LIST_REMOVE, LIST_FIRST, LIST_EMPTY
-     */
-    static struct Env *e;
-    --count;
-    while ((count <= 0) || (e->env_status != ENV_RUNNABLE)) {
-        // Env e is end, need scheduling, or env e is blocked, not runnable.
-//printf("sched!");
-        if (e != NULL) {
-            LIST_REMOVE(e, env_sched_link);
-            LIST_INSERT_TAIL(&env_sched_list[1 - point], e, env_sched_link);
-        }
-/*      if (LIST_EMPTY(&env_sched_list[point])) { // Current list is empty, switch to another list
-            point = 1 - point;
-        }*/
-        LIST_FOREACH(e, &env_sched_list[point], env_sched_link) {
-            if (e->env_status == ENV_RUNNABLE) {
-                break;
+    struct Env *w;
+
+    sched_pi_unwait(e);
+    while ((w = LIST_FIRST(&e->env_pi_waiters)) != NULL) {
+        LIST_REMOVE(w, env_pi_link);
+        w->env_pi_server = NULL;
+    }
+    e->env_inh_pri = 0;
+    sched_dequeue(e);
+    if (e->env_sched_class == SCHED_EDF) {
+        edf_total_bw -= e->env_dl_bw;
+        e->env_dl_bw = 0;
+    }
+    e->env_sched_class = SCHED_FAIR;
+}
+
+/* Overview:
+ *  Charge the cycles `e` has run since its last env_run (or last charge)
+ *  to its runtime. For a fair env the charge is divided by its weight,
+ *  env_pri, before being added to env_vruntime.
+ */
+void
+sched_update_curr(struct Env *e)
+{
+    u_int64_t now = get_cycle();
+    u_int64_t delta = now - e->env_exec_start;
+
+    e->env_exec_start = now;
+    e->env_runtime += delta;
+    if (e->env_sched_class == SCHED_EDF) {
+        e->env_dl_budget = e->env_dl_budget > delta ? e->env_dl_budget - delta : 0;
+        if (e->env_dl_budget == 0 && e->env_on_rq && !e->env_dl_throttled) {
+            LIST_REMOVE(e, env_dl_link);
+            e->env_dl_throttled = 1;
+            LIST_INSERT_HEAD(&edf_throttled, e, env_dl_link);
+        }
+        return;
+    }
+    if (e->env_sched_class != SCHED_FAIR) {
+        return;
+    }
+    e->env_vruntime += delta / fair_weight(e);
+    if (e->env_on_rq) {
+        fair_sift_down(e->env_heap_idx);
+    }
+    fair_update_min();
+}
+
+/* Overview:
+ *  Ask the next fair pick to pass over `e` once, so a yielding env gives
+ *  way even when its virtual runtime is still the smallest.
+ */
+void
+sched_skip_once(struct Env *e)
+{
+    if (e->env_sched_class == SCHED_FAIR) {
+        fair_skip = e;
+    }
+}
+
+/* Overview:
+ *  Switch straight to the runnable env `e`, handing it what is left of
+ *  the current env's time slice. A fair target whose virtual runtime is
+ *  above the caller's has it lowered to the caller's, so the next tick
+ *  does not preempt it at once. The caller stays runnable.
+ *
+ * Pre-Condition:
+ *  `e` is on its runqueue, is not curenv, and sched_can_yield_to(e).
+ */
+void
+sched_yield_to(struct Env *e)
+{
+    if (curenv != NULL) {
+        sched_update_curr(curenv);
+        if (curenv->env_sched_class == SCHED_FAIR &&
+            e->env_sched_class == SCHED_FAIR &&
+            curenv->env_vruntime < e->env_vruntime) {
+            e->env_vruntime = curenv->env_vruntime;
+            fair_sift_up(e->env_heap_idx);
+        }
+        sched_skip_once(curenv);
+    }
+    if (e->env_dl_wakeup != 0) {
+        sched_dl_lat_hist[lat_bucket(get_cycle() - e->env_dl_wakeup)]++;
+        e->env_dl_wakeup = 0;
+    }
+    sched_need_resched = 0;
+    env_run(e);
+}
+
+/* Overview:
+ *  Priority `e` is scheduled at: its own env_pri, raised to that of the
+ *  clients blocked on its reply while there are any.
+ */
+u_int
+sched_eff_pri(struct Env *e)
+{
+    return e->env_inh_pri > e->env_pri ? e->env_inh_pri : e->env_pri;
+}
+
+/* Overview:
+ *  Recompute the inherited priority of `e` from its waiters, and pass a
+ *  change on down the chain of servers it is itself waiting on. The
+ *  walk is bounded so a wait cycle cannot hang the kernel.
+ */
+static void
+pi_recompute(struct Env *e)
+{
+    struct Env *w;
+    u_int pri;
+    int depth;
+
+    for (depth = 0; e != NULL && depth < NENV; depth++) {
+        pri = 0;
+        LIST_FOREACH(w, &e->env_pi_waiters, env_pi_link) {
+            if (sched_eff_pri(w) > pri) {
+                pri = sched_eff_pri(w);
             }
         }
-        if (e != NULL) {
-            count = e->env_pri;
-        } else {
-            point = 1 - point;
-            count = -1;
+        if (pri == e->env_inh_pri) {
+            return;
+        }
+        if (e == curenv) {
+            sched_update_curr(e);   // charge what ran so far at the old weight
+        }
+        e->env_inh_pri = pri;
+        e = e->env_pi_server;
+    }
+}
+
+/* Overview:
+ *  Record that `e` is blocked until `server` replies, lending `server`
+ *  (and whoever it waits on) e's priority in the meantime.
+ */
+void
+sched_pi_wait(struct Env *e, struct Env *server)
+{
+    if (server == NULL || server == e || server->env_status == ENV_FREE) {
+        return;
+    }
+    sched_pi_unwait(e);
+    e->env_pi_server = server;
+    LIST_INSERT_HEAD(&server->env_pi_waiters, e, env_pi_link);
+    pi_recompute(server);
+}
+
+/* Overview:
+ *  `e` got its message: stop lending its priority.
+ */
+void
+sched_pi_unwait(struct Env *e)
+{
+    struct Env *server = e->env_pi_server;
+
+    if (server == NULL) {
+        return;
+    }
+    LIST_REMOVE(e, env_pi_link);
+    e->env_pi_server = NULL;
+    pi_recompute(server);
+}
+
+/* Overview:
+ *  The hart this code runs on. The kernel is single-hart for now, so
+ *  that is always the one SBI booted us on.
+ */
+u_int
+sched_this_hart(void)
+{
+    extern u_int64_t boot_hartid;
+
+    return (u_int)boot_hartid;
+}
+
+/* Overview:
+ *  Mask of the harts the scheduler runs on.
+ */
+u_int
+sched_online_harts(void)
+{
+    return 1 << sched_this_hart();
+}
+
+/* Overview:
+ *  Whether `e` may run on this hart.
+ */
+int
+sched_allowed(struct Env *e)
+{
+    return (e->env_hartmask >> sched_this_hart()) & 1;
+}
+
+/* Overview:
+ *  Whether the cpu may be handed straight to `e` by sched_yield_to: it
+ *  may run on this hart and is not a SCHED_EDF env that has spent its
+ *  budget. A throttled env stays on its runqueue (on edf_throttled),
+ *  so env_on_rq alone does not say it may run.
+ */
+int
+sched_can_yield_to(struct Env *e)
+{
+    return sched_allowed(e) && !e->env_dl_throttled;
+}
+
+/* Overview:
+ *  Restrict `e` to the harts in `hartmask`. If curenv is no longer
+ *  allowed here it is switched away from at the next reschedule point.
+ *
+ * Post-Condition:
+ *  Return 0 on success, -E_INVAL if no hart in the mask is online.
+ */
+int
+sched_set_affinity(struct Env *e, u_int hartmask)
+{
+    if ((hartmask & sched_online_harts()) == 0) {
+        return -E_INVAL;
+    }
+    e->env_hartmask = hartmask;
+    if (e == curenv && !sched_allowed(e)) {
+        sched_need_resched = 1;
+    }
+    return 0;
+}
+
+/* Overview:
+ *  Print the edf wakeup-to-run latency histogram, one line per
+ *  non-empty log2 bucket.
+ */
+void
+sched_dl_latency_dump(void)
+{
+    int i;
+
+    printf("edf wakeup latency (cycles):\n");
+    for (i = 0; i < SCHED_LAT_BUCKETS; i++) {
+        if (sched_dl_lat_hist[i] != 0) {
+            printf("  [2^%d, 2^%d)\t%d\n", i, i + 1, sched_dl_lat_hist[i]);
+        }
+    }
+}
+
+/* Overview:
+ *  Nothing to run. Drain the kernel log, then sleep until an interrupt
+ *  rather than spin. The periodic clock tick bounds the sleep, so futex
+ *  timeouts and EDF replenishments are still noticed within a tick.
+ */
+static void
+sched_idle(void)
+{
+    klog_flush();
+    asm volatile("csrs sstatus, %0\n\t"
+                 "wfi\n\t"
+                 "csrc sstatus, %0" : : "r"(SSTATUS_SIE) : "memory");
+}
+
+/* Overview:
+ *  Pick the next env and run it. SCHED_EDF envs with budget left are
+ *  served first, earliest deadline first; then SCHED_RR envs; then
+ *  SCHED_FAIR ones, smallest virtual runtime first.
+ */
+void sched_yield(void)
+{
+    struct Env *e;
+
+    if (curenv != NULL) {
+        sched_update_curr(curenv);
+    }
+    sched_need_resched = 0;
+    for (;;) {
+        edf_replenish();
+        futex_expire();
+        if ((e = edf_pick()) != NULL || (e = rr_pick()) != NULL ||
+            (e = fair_pick()) != NULL) {
+            break;
         }
-//printf("count:%d\n", count);
+        sched_idle();
     }
-//printf("\nsched!run:%x,pc at %x\n", e->env_id, e->env_tf.cp0_epc);
     env_run(e);
 }
 /*
@@ -62,4 +732,3 @@ void sched_yield_from_int(void) {
         printf("sched_yield call from interrupt!\n");
         return;
 }*/
-    
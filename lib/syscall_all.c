@@ -4,6 +4,15 @@
 #include <printf.h>
 #include <pmap.h>
 #include <sched.h>
+#include <fpu.h>
+#include <ipc.h>
+#include <notif.h>
+#include <futex.h>
+#include <endpoint.h>
+#include <sysring.h>
+#include <sysstat.h>
+#include <unistd.h>
+#include <cons.h>
 
 extern char *KERNEL_SP;
 extern struct Env *curenv;
@@ -16,7 +25,8 @@ extern struct Env *curenv;
  */
 void sys_putchar(int sysno, int c, int a2, int a3, int a4, int a5)
 {
-	printcharc((char) c);
+	cons_putc(c);
+	cons_flush();
 	return ;
 }
 
@@ -73,13 +83,53 @@ u_int sys_getenvid(void)
 /*** exercise 4.6 ***/
 void sys_yield(void)
 {
-        bcopy((void *)(KERNEL_SP - sizeof(struct Trapframe)),
-              (void *)(TIMESTACK - sizeof(struct Trapframe)),
-              sizeof(struct Trapframe));
 //printf("syscall_yield!\n");
+        sched_skip_once(curenv);
         sched_yield();
 }
 
+/* Overview:
+ * 	Finish the current syscall with return value `ret` and switch
+ * straight to the runnable env `e`, donating the rest of our time slice.
+ * If `e` is a SCHED_EDF env out of budget, just reschedule instead.
+ * Does not return.
+ */
+static void sys_switch_to(struct Env *e, int ret)
+{
+        curenv->env_tf.regs[10] = ret;  // a0 when we are resumed
+        if (sched_can_yield_to(e)) {
+                sched_yield_to(e);
+        }
+        sched_yield();
+}
+
+/* Overview:
+ * 	Directed yield: give the cpu, and what is left of our time slice,
+ * to `envid`. Used by spinning senders to let the env they wait on run.
+ *
+ * Post-Condition:
+ * 	Return 0 once we are scheduled again, -E_INVAL if the target is not
+ * runnable or is a SCHED_EDF env out of budget, or the envid2env error.
+ */
+int sys_yield_to(int sysno, u_int envid)
+{
+        struct Env *e;
+        int r;
+
+        if ((r = envid2env(envid, &e, 0)) != 0) {
+                return r;
+        }
+        if (e == curenv) {
+                return 0;
+        }
+        if (e->env_status != ENV_RUNNABLE || !e->env_on_rq ||
+            !sched_can_yield_to(e)) {
+                return -E_INVAL;
+        }
+        sys_switch_to(e, 0);
+        return 0;
+}
+
 /* Overview:
  * 	This function is used to destroy the current environment.
  *
@@ -313,12 +363,16 @@ int sys_env_alloc(void)
                 return r;
         }
         e->env_status = ENV_NOT_RUNNABLE;
-        bcopy((struct Trapframe *)(KERNEL_SP - sizeof(struct Trapframe)), &(e->env_tf), sizeof(struct Trapframe));
-//      bcopy((void *)(KERNEL_SP - sizeof(struct Trapframe)), &(curenv->env_tf), sizeof(struct Trapframe));
-//      bcopy(&(curenv->env_tf), &(e->env_tf), sizeof(struct Trapframe));
+        e->env_tf = curenv->env_tf;
+        fpu_fork(curenv, e);
         e->env_tf.pc = e->env_tf.epc;
-        e->env_tf.regs[2] = 0; // Return value of son process!!
+        e->env_tf.regs[10] = 0; // Return value of son process!!
         e->env_pri = curenv->env_pri;
+        e->env_hartmask = curenv->env_hartmask;
+        // a deadline reservation is not inherited; EDF parents fork fair children
+        if (curenv->env_sched_class != SCHED_EDF) {
+                e->env_sched_class = curenv->env_sched_class;
+        }
 //printf("sys_env_alloc end!\n");
         return e->env_id;      // Return value of father process.
         //      panic("sys_env_alloc not implemented");
@@ -351,12 +405,12 @@ int sys_set_env_status(int sysno, u_int envid, u_int status)
             status != ENV_FREE) {
                 return -E_INVAL;
         }
-        if (env->env_status != ENV_RUNNABLE && status == ENV_RUNNABLE) {
-                LIST_INSERT_HEAD(&env_sched_list[0], env, env_sched_link);
+        if (status == ENV_RUNNABLE) {
+                sched_enqueue(env);
 //printf("process %x inserted to sched link!\n", envid);
         }
-        if (env->env_status == ENV_RUNNABLE && status == ENV_NOT_RUNNABLE) {
-                LIST_REMOVE(env, env_sched_link);
+        if (status == ENV_NOT_RUNNABLE) {
+                sched_dequeue(env);
         }
         env->env_status = status;
         if (env->env_status == ENV_FREE) {
@@ -366,6 +420,81 @@ int sys_set_env_status(int sysno, u_int envid, u_int status)
         //      panic("sys_env_set_status not implemented");
 }
 
+/* Overview:
+ * 	Set envid's scheduling class to `class` (SCHED_FAIR or SCHED_RR).
+ * If `pri` is non-zero it also becomes envid's env_pri, which is the
+ * weight of a fair env and the slice count of a round-robin one.
+ *
+ * Post-Condition:
+ * 	Returns 0 on success, < 0 on error.
+ * 	Return -E_INVAL if `class` is not a known scheduling class.
+ */
+int sys_set_sched(int sysno, u_int envid, u_int class, u_int pri)
+{
+        struct Env *env;
+        int ret;
+
+        if ((ret = envid2env(envid, &env, 1)) != 0) {
+                return ret;
+        }
+        if (env == curenv) {
+                // settle the runtime accrued so far at the old weight
+                sched_update_curr(env);
+        }
+        if ((ret = sched_set_class(env, class)) != 0) {
+                return ret;
+        }
+        if (pri != 0) {
+                env->env_pri = pri;
+        }
+        return 0;
+}
+
+/* Overview:
+ * 	Give envid a deadline reservation of `runtime` cycles in every
+ * `period` cycles, each due `deadline` cycles after its period starts
+ * (0 means at the end of the period), and move it to SCHED_EDF. EDF
+ * envs run ahead of all best-effort envs while they have budget.
+ *
+ * Post-Condition:
+ * 	Returns 0 on success, < 0 on error.
+ * 	Return -E_INVAL if the parameters are inconsistent.
+ * 	Return -E_NO_BANDWIDTH if admission control rejects the reservation.
+ */
+int sys_set_deadline(int sysno, u_int envid, u_int runtime, u_int period,
+                     u_int deadline)
+{
+        struct Env *env;
+        int ret;
+
+        if ((ret = envid2env(envid, &env, 1)) != 0) {
+                return ret;
+        }
+        if (env == curenv) {
+                sched_update_curr(env);
+        }
+        return sched_set_deadline(env, runtime, period, deadline);
+}
+
+/* Overview:
+ * 	Pin envid to the harts set in `hartmask` (bit h = hart h).
+ * 	The env's migrations are counted in env_migrations.
+ *
+ * Post-Condition:
+ * 	Return 0 on success, -E_INVAL if no hart in the mask is online,
+ * or the envid2env error.
+ */
+int sys_set_affinity(int sysno, u_int envid, u_int hartmask)
+{
+        struct Env *env;
+        int ret;
+
+        if ((ret = envid2env(envid, &env, 1)) != 0) {
+                return ret;
+        }
+        return sched_set_affinity(env, hartmask);
+}
+
 /* Overview:
  * 	Set envid's trap frame to tf.
  *
@@ -407,25 +536,54 @@ void sys_panic(int sysno, char *msg)
  *
  * Pre-Condition:
  * 	`dstva` is valid (Note: NULL is also a valid value for `dstva`).
+ * 	`server` is 0, or the env whose reply we wait for; it then runs
+ * with our priority if that is higher than its own until a message
+ * reaches us.
  * 
  * Post-Condition:
  * 	This syscall will set the current process's status to 
  * ENV_NOT_RUNNABLE, giving up cpu. 
  */
 /*** exercise 4.7 ***/
-void sys_ipc_recv(int sysno, u_int dstva)
+void sys_ipc_recv(int sysno, u_int dstva, u_int server)
 {
+        struct Env *e;
+
         /* Note: This function is to mark current env be recevable. */
         if (dstva >= UTOP) {
                 return;
         }
         curenv->env_ipc_recving = 1;
+        curenv->env_ipc_recv_from = 0;
         curenv->env_ipc_dstva = dstva;
+        /* A sender is already queued on us: take its message and go on. */
+        if (ipc_complete_sender(curenv) != NULL) {
+                return;
+        }
+        if (server != 0 && envid2env(server, &e, 0) == 0) {
+                sched_pi_wait(curenv, e);
+        }
+        ep_wait(curenv);
         curenv->env_status = ENV_NOT_RUNNABLE;
+        sched_dequeue(curenv);
 //      syscall_set_env_status(0, ENV_NOT_RUNNABLE);
         sys_yield();
 }
 
+/* Overview:
+ * 	sys_ipc_recv accepting a grant of up to 'npages' pages, mapped
+ * from 'dstva' on.
+ */
+int sys_ipc_recv_pages(int sysno, u_int dstva, u_int npages)
+{
+        if (dstva >= UTOP || npages == 0 || npages > (UTOP - dstva) / BY2PG) {
+                return -E_INVAL;
+        }
+        curenv->env_ipc_dstpages = npages;
+        sys_ipc_recv(sysno, dstva, 0);
+        return 0;
+}
+
 /* Overview:
  * 	Try to send 'value' to the target env 'envid'.
  *
@@ -457,26 +615,569 @@ int sys_ipc_can_send(int sysno, u_int envid, u_int value, u_int srcva,
         if (srcva >= UTOP) {
                 return -E_INVAL;
         }
-        if (e->env_ipc_recving != 1) {
+        if (!ipc_can_deliver(curenv, e)) {
                 return -E_IPC_NOT_RECV;
         }
 
-        e->env_ipc_recving = 0;
-        e->env_ipc_from = curenv->env_id;
-        e->env_ipc_value = value;
-        e->env_status = ENV_RUNNABLE;
-//      syscall_set_env_status(envid, ENV_RUNNABLE);
+        if ((r = ipc_deliver(curenv, e, value, srcva, 1, perm)) != 0) {
+                return r;
+        }
 
-        /* If srcva != 0, you need to map current env's page (mapped by srcva)
-         * to destination env (at e->env_ipc_dstva). */
-        if (srcva != 0) {
-                r = sys_mem_map(sysno, curenv->env_id, srcva, e->env_id, e->env_ipc_dstva, perm);
-                e->env_ipc_perm = perm;
-                if (r != 0) {
+        /* Hand the receiver our slice so the reply comes back at once. */
+        if (e != curenv && sched_allowed(e)) {
+                sys_switch_to(e, 0);
+        }
+        return 0;
+}
+
+/* Overview:
+ * 	sys_ipc_send granting 'npages' pages from 'srcva' in one message,
+ * or, if 'npages' is IPC_PAGES_SG, the ranges given as IPC_SEG words in
+ * the register message. The receiver must have opened a window of at
+ * least that many pages with sys_ipc_recv_pages; the pages are mapped
+ * there back to back with a single TLB flush.
+ *
+ * Post-Condition:
+ * 	As sys_ipc_send; -E_INVAL also if a page is not mapped or the
+ * grant does not fit the receiver's window.
+ */
+int sys_ipc_send_pages(int sysno, u_int envid, u_int value, u_int srcva,
+                       u_int npages, u_int perm)
+{
+        int r;
+        struct Env *e;
+
+        if ((r = envid2env(envid, &e, 0)) != 0) {
+                return r;
+        }
+        if (srcva >= UTOP || e == curenv) {
+                return -E_INVAL;
+        }
+        if (ipc_can_deliver(curenv, e)) {
+                if ((r = ipc_deliver(curenv, e, value, srcva, npages,
+                                     perm)) != 0) {
                         return r;
                 }
+                if (sched_allowed(e)) {
+                        sys_switch_to(e, 0);
+                }
+                return 0;
         }
+        ipc_queue_sender(curenv, e, value, srcva, npages, perm);
+        sys_yield();    // the receiver sets our a0 when it takes the message
+        return 0;
+}
+
+/* Overview:
+ * 	Send 'value' (and the page at 'srcva' if it is not 0) to 'envid',
+ * blocking until it is received. If the target is not in sys_ipc_recv
+ * the caller is queued on it without using any cpu; the target's
+ * receives take queued senders in FIFO order.
+ *
+ * Post-Condition:
+ * 	Return 0 once the message is delivered, the mapping error if
+ * the page could not be mapped, -E_BAD_ENV if the target went away,
+ * or -E_INVAL for a bad srcva or a send to oneself.
+ */
+int sys_ipc_send(int sysno, u_int envid, u_int value, u_int srcva,
+                 u_int perm)
+{
+        return sys_ipc_send_pages(sysno, envid, value, srcva, 1, perm);
+}
+
+/* Overview:
+ * 	Synchronous call: send 'value' (and the page at 'srcva' if it is
+ * not 0) to 'envid', then wait for its reply, which only 'envid' can
+ * give. When 'envid' is already receiving, the cpu is switched to it
+ * directly instead of going through the scheduler.
+ *
+ * Post-Condition:
+ * 	Return 0 once the reply is in env_ipc_value (and its page, if any,
+ * mapped at 'dstva'), or < 0 on error.
+ */
+int sys_ipc_call(int sysno, u_int envid, u_int value, u_int srcva,
+                 u_int perm, u_int dstva)
+{
+        int r;
+        struct Env *e;
 
+        if ((r = envid2env(envid, &e, 0)) != 0) {
+                return r;
+        }
+        if (srcva >= UTOP || dstva >= UTOP || e == curenv) {
+                return -E_INVAL;
+        }
+        curenv->env_ipc_dstva = dstva;
+        if (!ipc_can_deliver(curenv, e)) {
+                curenv->env_ipc_calling = 1;
+                ipc_queue_sender(curenv, e, value, srcva, 1, perm);
+                sys_yield();    // does not return; the reply wakes us
+        }
+        if ((r = ipc_deliver(curenv, e, value, srcva, 1, perm)) != 0) {
+                return r;
+        }
+        ipc_wait_reply(curenv, e);
+        if (sched_can_yield_to(e)) {
+                sched_yield_to(e);
+        }
+        sched_yield();
+        return 0;
+}
+
+/* Overview:
+ * 	Server side of sys_ipc_call: reply to 'envid' (skipped if it is 0
+ * or not waiting for us) with 'value' and the page at 'srcva', then
+ * receive the next request at 'dstva'. If no request is queued, the
+ * cpu goes straight to the client just answered. If the reply page
+ * cannot be mapped, the client's ipc_call returns the error.
+ *
+ * Post-Condition:
+ * 	Return 0 once the next request is in env_ipc_value/env_ipc_from,
+ * or -E_INVAL for a bad va.
+ */
+int sys_ipc_reply_recv(int sysno, u_int envid, u_int value, u_int srcva,
+                       u_int perm, u_int dstva)
+{
+        struct Env *e = NULL;
+        int r;
+
+        if (srcva >= UTOP || dstva >= UTOP) {
+                return -E_INVAL;
+        }
+        if (envid != 0 && envid2env(envid, &e, 0) == 0 &&
+            ipc_can_deliver(curenv, e)) {
+                // a reply page that cannot be mapped fails the client's
+                // ipc_call; the value still reaches it
+                if ((r = ipc_deliver(curenv, e, value, srcva, 1, perm)) < 0) {
+                        e->env_tf.regs[10] = r;
+                }
+        } else {
+                e = NULL;
+        }
+        curenv->env_ipc_recving = 1;
+        curenv->env_ipc_recv_from = 0;
+        curenv->env_ipc_dstva = dstva;
+        if (ipc_complete_sender(curenv) != NULL) {
+                return 0;
+        }
+        ep_wait(curenv);
+        curenv->env_status = ENV_NOT_RUNNABLE;
+        sched_dequeue(curenv);
+        if (e != NULL && sched_can_yield_to(e)) {
+                sched_yield_to(e);
+        }
+        sched_yield();
         return 0;
 }
 
+
+/* Overview:
+ * 	Allocate a notification object owned by the current env.
+ *
+ * Post-Condition:
+ * 	Return its id (> 0), or -E_NO_MEM if none is free.
+ */
+int sys_notif_alloc(int sysno)
+{
+        u_int id;
+        int r;
+
+        if ((r = notif_alloc(curenv, &id)) < 0) {
+                return r;
+        }
+        return id;
+}
+
+/* Overview:
+ * 	Free the notification object 'id', which the current env must own.
+ *
+ * Post-Condition:
+ * 	Return 0 on success, -E_INVAL for a bad id or one owned by another env.
+ */
+int sys_notif_free(int sysno, u_int id)
+{
+        struct Notif *n;
+        int r;
+
+        if ((r = notif_lookup(id, &n)) < 0) {
+                return r;
+        }
+        if (n->n_owner != curenv->env_id) {
+                return -E_INVAL;
+        }
+        notif_cancel(curenv);
+        notif_free(n);
+        return 0;
+}
+
+/* Overview:
+ * 	Set 'bits' in notification object 'id'. Any env may signal, and
+ * the signaller never blocks: the bits stay pending until the owner
+ * waits, or wake it at once if it is already waiting.
+ *
+ * Post-Condition:
+ * 	Return 0 on success, -E_INVAL for a bad id.
+ */
+int sys_notif_signal(int sysno, u_int id, u_int bits)
+{
+        struct Notif *n;
+        int r;
+
+        if ((r = notif_lookup(id, &n)) < 0) {
+                return r;
+        }
+        notif_signal(n, bits);
+        return 0;
+}
+
+/* Overview:
+ * 	Wait for notification object 'id' to be signalled and take all of
+ * its pending bits into env_notif_bits. If 'recv' is set, also receive
+ * an IPC message at 'dstva' as sys_ipc_recv does; whichever comes first
+ * ends the wait.
+ *
+ * Post-Condition:
+ * 	Return NOTIF_WOKEN when bits were taken, 0 when an IPC message was
+ * received instead, or -E_INVAL for a bad id, an id owned by another env,
+ * or a bad dstva.
+ */
+int sys_notif_wait(int sysno, u_int id, u_int recv, u_int dstva)
+{
+        struct Notif *n;
+        int r;
+
+        if ((r = notif_lookup(id, &n)) < 0) {
+                return r;
+        }
+        if (n->n_owner != curenv->env_id || dstva >= UTOP) {
+                return -E_INVAL;
+        }
+        if (notif_wait(curenv, n)) {
+                return NOTIF_WOKEN;
+        }
+        if (recv) {
+                curenv->env_ipc_recving = 1;
+                curenv->env_ipc_recv_from = 0;
+                curenv->env_ipc_dstva = dstva;
+                if (ipc_complete_sender(curenv) != NULL) {
+                        return 0;
+                }
+                ep_wait(curenv);
+        }
+        curenv->env_status = ENV_NOT_RUNNABLE;
+        sched_dequeue(curenv);
+        sched_yield();
+        return 0;
+}
+
+/* Overview:
+ * 	Block until woken by sys_futex_wake on the word at 'va', provided
+ * it still holds 'expected'; the check and the sleep are atomic with
+ * respect to wakers. Waits are keyed by physical address, so envs
+ * sharing a page meet whatever va each maps it at. 'timeout' is in
+ * cycles, 0 for none.
+ *
+ * Post-Condition:
+ * 	Return 0 when woken (possibly spuriously: recheck the word),
+ * -E_AGAIN if the word did not hold 'expected', -E_TIMEOUT, or -E_INVAL
+ * for a bad va.
+ */
+int sys_futex_wait(int sysno, u_int va, u_int expected, u_int timeout)
+{
+        volatile u_int *word;
+        u_long key;
+        int r;
+
+        if ((r = futex_key(curenv, va, &key, &word)) < 0) {
+                return r;
+        }
+        if (*word != expected) {
+                return -E_AGAIN;
+        }
+        futex_wait(curenv, key, timeout);
+        sched_yield();
+        return 0;
+}
+
+/* Overview:
+ * 	Wake up to 'n' envs waiting on the word at 'va', oldest first.
+ *
+ * Post-Condition:
+ * 	Return the number woken, or -E_INVAL for a bad va.
+ */
+int sys_futex_wake(int sysno, u_int va, u_int n)
+{
+        volatile u_int *word;
+        u_long key;
+        int r;
+
+        if ((r = futex_key(curenv, va, &key, &word)) < 0) {
+                return r;
+        }
+        return futex_wake(key, n);
+}
+
+/* Overview:
+ * 	Allocate an IPC endpoint owned by the current env.
+ *
+ * Post-Condition:
+ * 	Return its id (> 0), or -E_NO_MEM if none is free.
+ */
+int sys_ep_alloc(int sysno)
+{
+        u_int id;
+        int r;
+
+        if ((r = ep_alloc(curenv, &id)) < 0) {
+                return r;
+        }
+        return id;
+}
+
+/* Overview:
+ * 	Make 'envid' (0 for the current env) a server of endpoint 'id', or
+ * stop it serving if 'id' is 0: its open receives then also take calls
+ * made to the endpoint, each going to whichever server is idle. Only
+ * the endpoint's owner may grant this; an env may always unbind itself.
+ *
+ * Post-Condition:
+ * 	Return 0, -E_INVAL, or the envid2env error.
+ */
+int sys_ep_bind(int sysno, u_int id, u_int envid)
+{
+        struct Env *e;
+        int r;
+
+        if ((r = envid2env(envid, &e, 0)) != 0) {
+                return r;
+        }
+        return ep_bind(curenv, e, id);
+}
+
+/* Overview:
+ * 	sys_ipc_call to endpoint 'id' instead of an env: the request goes
+ * to the longest-idle server of the endpoint, or waits in FIFO order
+ * for one. The reply comes from that server, as the env_ipc_from of
+ * the request tells it whom to answer.
+ *
+ * Post-Condition:
+ * 	Return 0 once the reply is in env_ipc_value, -E_BAD_ENV if the
+ * endpoint or the server went away, or -E_INVAL.
+ */
+int sys_ep_call(int sysno, u_int id, u_int value, u_int srcva, u_int perm,
+                u_int dstva)
+{
+        struct Endpoint *ep;
+        struct Env *e;
+        int r;
+
+        if ((r = ep_lookup(id, &ep)) < 0) {
+                return r;
+        }
+        if (srcva >= UTOP || dstva >= UTOP) {
+                return -E_INVAL;
+        }
+        curenv->env_ipc_dstva = dstva;
+        if ((e = TAILQ_FIRST(&ep->ep_receivers)) == NULL) {
+                ep_queue_sender(curenv, ep, value, srcva, perm);
+                sched_yield();  // a server's receive takes the call
+        }
+        if ((r = ipc_deliver(curenv, e, value, srcva, 1, perm)) != 0) {
+                return r;
+        }
+        ipc_wait_reply(curenv, e);
+        if (sched_can_yield_to(e)) {
+                sched_yield_to(e);
+        }
+        sched_yield();
+        return 0;
+}
+
+/* Overview:
+ * 	Use the page at 'va' as the current env's syscall ring (see
+ * include/sysring.h), or drop the ring if 'va' is 0.
+ *
+ * Post-Condition:
+ * 	Return 0, or -E_INVAL if 'va' is not a page mapped below UTOP.
+ */
+int sys_sysring_setup(int sysno, u_int va)
+{
+        return sysring_register(curenv, va);
+}
+
+/* Overview:
+ * 	Run one queued ring entry for sys_sysring_enter. Only calls that
+ * return to their caller are accepted: an IPC send is made only if the
+ * target is already receiving, and without giving it the cpu.
+ */
+static int sysring_call(struct Sysring_sqe *sqe)
+{
+        u_int *a = sqe->sq_args;
+        struct Env *e;
+        int r;
+
+        switch (sqe->sq_sysno) {
+        case SYS_mem_alloc:
+                return sys_mem_alloc(SYS_mem_alloc, a[0], a[1], a[2]);
+        case SYS_mem_map:
+                return sys_mem_map(SYS_mem_map, a[0], a[1], a[2], a[3], a[4]);
+        case SYS_mem_unmap:
+                return sys_mem_unmap(SYS_mem_unmap, a[0], a[1]);
+        case SYS_set_env_status:
+                if (a[1] == ENV_FREE) {
+                        return -E_INVAL;
+                }
+                return sys_set_env_status(SYS_set_env_status, a[0], a[1]);
+        case SYS_ipc_can_send:
+                if ((r = envid2env(a[0], &e, 0)) != 0) {
+                        return r;
+                }
+                if (a[2] >= UTOP || e == curenv) {
+                        return -E_INVAL;
+                }
+                if (!ipc_can_deliver(curenv, e)) {
+                        return -E_IPC_NOT_RECV;
+                }
+                return ipc_deliver(curenv, e, a[1], a[2], 1, a[3]);
+        case SYS_notif_signal:
+                return sys_notif_signal(SYS_notif_signal, a[0], a[1]);
+        case SYS_futex_wake:
+                return sys_futex_wake(SYS_futex_wake, a[0], a[1]);
+        default:
+                return -E_INVAL;
+        }
+}
+
+/* Overview:
+ * 	Run the syscalls queued on the current env's ring with a single
+ * trap: mem_alloc, mem_map, mem_unmap, set_env_status, ipc_can_send,
+ * notif_signal and futex_wake. Each result goes to the completion
+ * queue; the ring header counts the failures of the batch. With
+ * SYSRING_STOP in 'flags' the batch ends at the first failure and the
+ * entries after it stay queued.
+ *
+ * Post-Condition:
+ * 	Return the number of entries run, or -E_INVAL if there is no ring
+ * or its indices are corrupt.
+ */
+int sys_sysring_enter(int sysno, u_int flags)
+{
+        return sysring_run(curenv, flags, sysring_call);
+}
+
+/* Overview:
+ * 	Syscall instrumentation, see include/sysstat.h. 'op' is one of
+ * SYSSTAT_ENABLE (counting on if 'arg' is non-zero), SYSSTAT_RESET,
+ * SYSSTAT_GET (copy the struct Sysstat of syscall 'arg', numbered from
+ * 0, to 'dstva'), SYSSTAT_DUMP (print everything on the console) or
+ * SYSSTAT_DL_DUMP (print the edf wakeup latency histogram). Per-env
+ * counts are in envs[].env_sys_count.
+ *
+ * Post-Condition:
+ * 	Return 0 (SYSSTAT_ENABLE: whether counting was on), or -E_INVAL
+ * for a bad op, syscall or 'dstva' (which must be mapped with PTE_R).
+ */
+int sys_sysstat(int sysno, u_int op, u_int arg, u_int dstva)
+{
+        struct Page *pp;
+        Pte *pte;
+        u_char *src;
+        u_int n, len;
+        int was;
+
+        switch (op) {
+        case SYSSTAT_ENABLE:
+                was = sysstat_on;
+                sysstat_on = arg != 0;
+                return was;
+        case SYSSTAT_RESET:
+                sysstat_reset();
+                return 0;
+        case SYSSTAT_GET:
+                if (arg >= __NR_SYSCALLS || dstva >= UTOP - sizeof(struct Sysstat)) {
+                        return -E_INVAL;
+                }
+                src = (u_char *)&sysstats[arg];
+                // page by page: the buffer may straddle two pages
+                for (len = sizeof(struct Sysstat); len > 0; len -= n) {
+                        n = MIN(len, BY2PG - (dstva & (BY2PG - 1)));
+                        if ((pp = page_lookup(curenv->env_pgdir, dstva,
+                                              &pte)) == NULL ||
+                            (*pte & PTE_R) == 0) {
+                                return -E_INVAL;
+                        }
+                        bcopy(src, (void *)(page2kva(pp) +
+                                            (dstva & (BY2PG - 1))), n);
+                        src += n;
+                        dstva += n;
+                }
+                return 0;
+        case SYSSTAT_DUMP:
+                sysstat_dump();
+                return 0;
+        case SYSSTAT_DL_DUMP:
+                sched_dl_latency_dump();
+                return 0;
+        default:
+                return -E_INVAL;
+        }
+}
+
+/* Overview:
+ * 	Take the next console input byte without blocking.
+ *
+ * Post-Condition:
+ * 	Return the byte, or 0 if none has arrived.
+ */
+int sys_cgetc(int sysno)
+{
+        return cons_getc();
+}
+
+/* Overview:
+ * 	Take the next console input byte, sleeping until the UART receive
+ * interrupt brings one; a waiting env costs no cpu.
+ *
+ * Post-Condition:
+ * 	Return the byte.
+ */
+int sys_cons_read(int sysno)
+{
+        int c;
+
+        if ((c = cons_getc()) != 0) {
+                return c;
+        }
+        cons_wait(curenv);
+        sched_yield();  // cons_intr sets our a0 to the byte
+        return 0;
+}
+
+/* Overview:
+ * 	Write 'len' bytes at 'va' to the console with one trap: they go
+ * through the kernel's output ring, which is flushed with as few SBI
+ * calls as it takes.
+ *
+ * Post-Condition:
+ * 	Return 'len', or -E_INVAL if the buffer is not mapped below UTOP.
+ */
+int sys_console_write(int sysno, u_int va, u_int len)
+{
+        struct Page *pp;
+        Pte *pte;
+        u_int n, done;
+
+        if (va >= UTOP || len > UTOP - va) {
+                return -E_INVAL;
+        }
+        for (done = 0; done < len; done += n, va += n) {
+                n = MIN(len - done, BY2PG - (va & (BY2PG - 1)));
+                if ((pp = page_lookup(curenv->env_pgdir, va, &pte)) == NULL) {
+                        cons_flush();
+                        return -E_INVAL;
+                }
+                cons_write((char *)page2kva(pp) + (va & (BY2PG - 1)), n);
+        }
+        cons_flush();
+        return len;
+}
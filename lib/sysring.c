@@ -0,0 +1,105 @@
+#include <env.h>
+#include <sysring.h>
+#include <pmap.h>
+#include <error.h>
+
+/* Overview:
+ *  Make the page mapped at `va` e's syscall ring, replacing any ring
+ *  it had; va 0 just drops the old one. The env holds a reference to
+ *  the page, so unmapping it does not pull it from under the kernel.
+ *
+ * Post-Condition:
+ *  Return 0, or -E_INVAL if `va` is unaligned, above UTOP or not mapped
+ *  with PTE_R.
+ */
+int
+sysring_register(struct Env *e, u_long va)
+{
+    struct Page *pp = NULL;
+    Pte *pte;
+
+    if (va != 0) {
+        if ((va & (BY2PG - 1)) != 0 || va >= UTOP) {
+            return -E_INVAL;
+        }
+        if ((pp = page_lookup(e->env_pgdir, va, &pte)) == NULL ||
+            (*pte & PTE_R) == 0) {
+            return -E_INVAL;
+        }
+        pp->pp_ref++;
+    }
+    sysring_exit(e);
+    if (pp != NULL) {
+        e->env_sysring_page = pp;
+        e->env_sysring = (struct Sysring *)page2kva(pp);
+    }
+    return 0;
+}
+
+/* Overview:
+ *  Run the entries queued on e's ring in order, calling `run` on each
+ *  and posting its result as a completion. Stop when the submission
+ *  queue is empty, the completion queue is full, or, with SYSRING_STOP,
+ *  after the first entry that fails. sr_errors and sr_first_error
+ *  describe the batch.
+ *
+ * Post-Condition:
+ *  Return the number of entries run, or -E_INVAL if e has no ring or
+ *  the user left its indices inconsistent.
+ */
+int
+sysring_run(struct Env *e, u_int flags, int (*run)(struct Sysring_sqe *sqe))
+{
+    struct Sysring *sr = e->env_sysring;
+    struct Sysring_sqe sqe;
+    struct Sysring_cqe *cqe;
+    u_int head, tail, cq_tail;
+    int n = 0, r;
+
+    if (sr == NULL) {
+        return -E_INVAL;
+    }
+    head = sr->sr_sq_head;
+    tail = sr->sr_sq_tail;
+    cq_tail = sr->sr_cq_tail;
+    if (tail - head > SYSRING_ENTRIES ||
+        cq_tail - sr->sr_cq_head > SYSRING_ENTRIES) {
+        return -E_INVAL;
+    }
+    sr->sr_errors = 0;
+    sr->sr_first_error = 0;
+
+    while (head != tail && cq_tail - sr->sr_cq_head < SYSRING_ENTRIES) {
+        // a private copy: the user may rewrite the slot meanwhile
+        sqe = sr->sr_sq[head & SYSRING_MASK];
+        r = run(&sqe);
+        cqe = &sr->sr_cq[cq_tail & SYSRING_MASK];
+        cqe->cq_data = sqe.sq_data;
+        cqe->cq_ret = r;
+        cq_tail++;
+        n++;
+        if (r < 0 && sr->sr_errors++ == 0) {
+            sr->sr_first_error = head;
+        }
+        head++;
+        if (r < 0 && (flags & SYSRING_STOP)) {
+            break;
+        }
+    }
+    sr->sr_sq_head = head;
+    sr->sr_cq_tail = cq_tail;
+    return n;
+}
+
+/* Overview:
+ *  Drop e's ring, if any; called when e is freed.
+ */
+void
+sysring_exit(struct Env *e)
+{
+    if (e->env_sysring_page != NULL) {
+        page_decref(e->env_sysring_page);
+    }
+    e->env_sysring_page = NULL;
+    e->env_sysring = NULL;
+}
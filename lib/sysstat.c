@@ -0,0 +1,106 @@
+#include <env.h>
+#include <sysstat.h>
+#include <kclock.h>
+#include <printf.h>
+
+/* Read by handle_sys on every syscall: while 0, calls go straight to
+ * sys_* and nothing here costs anything. */
+int sysstat_on;
+struct Sysstat sysstats[__NR_SYSCALLS];
+
+static int
+sysstat_bucket(u_int64_t cycles)
+{
+    int i = 0;
+
+    while (cycles > 1 && i < SYSSTAT_BUCKETS - 1) {
+        cycles >>= 1;
+        i++;
+    }
+    return i;
+}
+
+/* Overview:
+ *  Instrumented dispatch, used by handle_sys instead of calling `fn`
+ *  directly while sysstat_on is set. Counts the call for the syscall
+ *  and for curenv, and, if `fn` returns, its latency.
+ *
+ * Pre-Condition:
+ *  a0 is a syscall number handle_sys has range-checked.
+ */
+long
+sysstat_call(long a0, long a1, long a2, long a3, long a4, long a5,
+             long (*fn)(long, long, long, long, long, long))
+{
+    struct Sysstat *st = &sysstats[a0 - __SYSCALL_BASE];
+    u_int64_t start, cycles;
+    long r;
+
+    st->st_calls++;
+    curenv->env_sys_count[a0 - __SYSCALL_BASE]++;
+    start = get_cycle();
+    r = fn(a0, a1, a2, a3, a4, a5);
+    cycles = get_cycle() - start;
+    st->st_cycles += cycles;
+    st->st_hist[sysstat_bucket(cycles)]++;
+    return r;
+}
+
+/* Overview:
+ *  Zero the per-syscall counters and every env's env_sys_count.
+ */
+void
+sysstat_reset(void)
+{
+    int i;
+
+    bzero(sysstats, sizeof(sysstats));
+    for (i = 0; i < NENV; i++) {
+        bzero(envs[i].env_sys_count, sizeof(envs[i].env_sys_count));
+    }
+}
+
+/* Overview:
+ *  Print one line per syscall that was called, with its log2 latency
+ *  histogram, then the calls made by each live env.
+ */
+void
+sysstat_dump(void)
+{
+    struct Sysstat *st;
+    struct Env *e;
+    u_int64_t done;
+    int i, j;
+
+    printf("syscall stats (%s):\n", sysstat_on ? "on" : "off");
+    for (i = 0; i < __NR_SYSCALLS; i++) {
+        st = &sysstats[i];
+        if (st->st_calls == 0) {
+            continue;
+        }
+        for (done = 0, j = 0; j < SYSSTAT_BUCKETS; j++) {
+            done += st->st_hist[j];
+        }
+        printf("  sys %d: calls=%ld returned=%ld avg=%ld\n", i,
+               (long)st->st_calls, (long)done,
+               (long)(done ? st->st_cycles / done : 0));
+        for (j = 0; j < SYSSTAT_BUCKETS; j++) {
+            if (st->st_hist[j] != 0) {
+                printf("    [2^%d, 2^%d)\t%d\n", j, j + 1, st->st_hist[j]);
+            }
+        }
+    }
+    for (i = 0; i < NENV; i++) {
+        e = &envs[i];
+        if (e->env_status == ENV_FREE) {
+            continue;
+        }
+        printf("  env %08x:", e->env_id);
+        for (j = 0; j < __NR_SYSCALLS; j++) {
+            if (e->env_sys_count[j] != 0) {
+                printf(" %d=%d", j, e->env_sys_count[j]);
+            }
+        }
+        printf("\n");
+    }
+}
@@ -2,12 +2,18 @@
 #include <env.h>
 #include <printf.h>
 #include <types.h>
+#include <fpu.h>
+#include <kclock.h>
+#include <sched.h>
 
-extern void handle_int();
 extern void handle_reserved();
-extern void handle_tlb();
+extern void handle_ill();
+extern void handle_pgflt();
 extern void handle_sys();
-extern void handle_mod();
+extern void exc_handler(struct Trapframe *tf);
+
+/* Entry point for each scause of a user-mode exception; except_vec in
+ * boot/start.S jumps through it without looking at the cause. */
 u_ptr64_t exception_handlers[32];
 
 void trap_init()
@@ -18,11 +24,11 @@ void trap_init()
         set_except_vector(i, handle_reserved);
     }
 
-    set_except_vector(0, handle_int);
-    set_except_vector(1, handle_mod);
-    set_except_vector(2, handle_tlb);
-    set_except_vector(3, handle_tlb);
-    set_except_vector(8, handle_sys);
+    set_except_vector(T_ILLINST, handle_ill);
+    set_except_vector(T_ECALLFROMU, handle_sys);
+    set_except_vector(T_INSTPGFLT, handle_pgflt);
+    set_except_vector(T_LDPGFLT, handle_pgflt);
+    set_except_vector(T_STPGFLT, handle_pgflt);
 }
 void *set_except_vector(int n, void *addr)
 {
@@ -33,6 +39,52 @@ void *set_except_vector(int n, void *addr)
 }
 
 
+/* Overview:
+ *  Illegal instruction: the first FP instruction since a switch loads
+ *  curenv's FP state, anything else is fatal.
+ */
+void
+do_ill(struct Trapframe *tf)
+{
+    if (!fpu_trap(tf)) {
+        exc_handler(tf);
+    }
+}
+
+/* Overview:
+ *  Software interrupt: nothing raises one yet, just acknowledge it.
+ */
+void
+do_int_soft(struct Trapframe *tf)
+{
+    asm volatile("csrc sip, %0" : : "r"(SIP_SSIP));
+}
+
+/* Overview:
+ *  Clock tick: arm the next one and, if user mode was interrupted,
+ *  reschedule. sched_yield charges curenv for the slice it used, so a
+ *  CPU-bound env is preempted by weight, slice or spent budget rather
+ *  than running until it traps. A tick that ends an idle wfi just
+ *  lets sched_yield look again.
+ */
+void
+do_int_timer(struct Trapframe *tf)
+{
+    set_timer();
+    if (curenv != NULL && tf == &curenv->env_tf) {
+        sched_yield();
+    }
+}
+
+/* Overview:
+ *  An interrupt nobody enabled.
+ */
+void
+do_int_reserved(struct Trapframe *tf)
+{
+    exc_handler(tf);
+}
+
 struct pgfault_trap_frame {
     u_int fault_va;
     u_int err;
@@ -50,18 +102,21 @@ struct pgfault_trap_frame {
 /*** exercise 4.11 ***/
 void
 page_fault_handler(struct Trapframe *tf)
-{                                  // ^ tf is sp (see lib/genex.S)
+{                                  // ^ tf is curenv's env_tf (see SAVE_ALL)
     struct Trapframe PgTrapFrame;
     extern struct Env *curenv;
 
+    if (curenv == NULL || curenv->env_pgfault_handler == 0) {
+        exc_handler(tf);        // nowhere to send it
+    }
     bcopy(tf, &PgTrapFrame, sizeof(struct Trapframe));
 
-    if (tf->regs[29] >= (curenv->env_xstacktop - BY2PG) &&
-        tf->regs[29] <= (curenv->env_xstacktop - 1)) {
-            tf->regs[29] = tf->regs[29] - sizeof(struct  Trapframe);
-            bcopy(&PgTrapFrame, (void *)tf->regs[29], sizeof(struct Trapframe));
+    if (tf->regs[2] >= (curenv->env_xstacktop - BY2PG) &&
+        tf->regs[2] <= (curenv->env_xstacktop - 1)) {
+            tf->regs[2] = tf->regs[2] - sizeof(struct  Trapframe);
+            bcopy(&PgTrapFrame, (void *)tf->regs[2], sizeof(struct Trapframe));
         } else {
-            tf->regs[29] = curenv->env_xstacktop - sizeof(struct  Trapframe);
+            tf->regs[2] = curenv->env_xstacktop - sizeof(struct  Trapframe);
             bcopy(&PgTrapFrame,(void *)curenv->env_xstacktop - sizeof(struct  Trapframe),sizeof(struct Trapframe));
         }
     // TODO: Set EPC to a proper value in the trapframe
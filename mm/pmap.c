@@ -3,6 +3,9 @@
 #include "printf.h"
 #include "env.h"
 #include "error.h"
+#include "futex.h"
+#include "cons.h"
+#include "klog.h"
 
 
 
@@ -36,8 +39,8 @@ void riscv_detect_memory()
     extmem = 0;
     // Step 2: Calculate corresponding npage value.
 
-    printf("Physical memory: %dK available, ", (int)(maxpa / 1024));
-    printf("base = %dK, extended = %dK\n", (int)(basemem / 1024),
+    klog_info("Physical memory: %dK available, ", (int)(maxpa / 1024));
+    klog_info("base = %dK, extended = %dK\n", (int)(basemem / 1024),
            (int)(extmem / 1024));
 }
 
@@ -194,7 +197,7 @@ void boot_map_segment(Pte *vpt2, u_int64_t va, u_int64_t size, u_int64_t pa, u_i
 
     /* Step 1: Check if `size` is a multiple of BY2PG. */
     if (size % BY2PG != 0) {
-printf("Map size not 4K aligned!\n");
+klog_err("Map size not 4K aligned!\n");
         return;
     }
 //printf("With perm %lx to map: va from %lx to %lx, pa from %lx to %lx\n", perm, va, va + size, pa, pa+size);
@@ -307,36 +310,36 @@ void riscv_vm_init()
 
     Pte *vpt2;
     u_int64_t n;
-printf("sizeof u_int64_t:%d, sizeof Pte *:%d, sizeof void *:%d\n", sizeof(u_int64_t), sizeof(Pte *), sizeof(void *));
+klog_debug("sizeof u_int64_t:%d, sizeof Pte *:%d, sizeof void *:%d\n", sizeof(u_int64_t), sizeof(Pte *), sizeof(void *));
 
     /* Step 1: Allocate a page for page directory(first level page table). */
 
     vpt2 = alloc(BY2PG, BY2PG, 1);
-    printf("to memory %lx for struct page directory.\n", freemem);
+    klog_debug("to memory %lx for struct page directory.\n", freemem);
     mCONTEXT = (u_int64_t)vpt2;
-printf("Segments:\n.text:\tfrom:%lxto:%lx\n", start_text, end_text);
-printf(".bss:\tfrom:%lxto:%lx\n", start_bss, end_bss);
-printf(".data:\tfrom:%lxto:%lx\n", start_data, end_data);
-printf(".kern_stk:\tfrom:%lxto:%lx\n", start_kern_stk, end_kern_stk);
+klog_debug("Segments:\n.text:\tfrom:%lxto:%lx\n", start_text, end_text);
+klog_debug(".bss:\tfrom:%lxto:%lx\n", start_bss, end_bss);
+klog_debug(".data:\tfrom:%lxto:%lx\n", start_data, end_data);
+klog_debug(".kern_stk:\tfrom:%lxto:%lx\n", start_kern_stk, end_kern_stk);
     boot_vpt2 = vpt2;
     //boot_map_segment(vpt2, vpt2, BY2PG, vpt2, PTE_R);
     boot_map_vpt(vpt2, vpt2);
 
-    printf(".text need:0x%lx B\n", (u_int64_t)end_text - (u_int64_t)start_text);
+    klog_debug(".text need:0x%lx B\n", (u_int64_t)end_text - (u_int64_t)start_text);
     boot_map_segment(vpt2, start_text, (u_int64_t)end_text - (u_int64_t)start_text, start_text, PTE_R | PTE_X);
-    printf(".text mapped!\n");
+    klog_debug(".text mapped!\n");
 
-printf(".bss need:0x%lx B\n", (u_int64_t)end_bss - (u_int64_t)start_bss);
+klog_debug(".bss need:0x%lx B\n", (u_int64_t)end_bss - (u_int64_t)start_bss);
     boot_map_segment(vpt2, start_bss, (u_int64_t)end_bss - (u_int64_t)start_bss, start_bss, PTE_R | PTE_W);
-    printf(".bss mapped!\n");
+    klog_debug(".bss mapped!\n");
 
-printf(".data need:0x%lx B\n", (u_int64_t)end_data - (u_int64_t)start_data);
+klog_debug(".data need:0x%lx B\n", (u_int64_t)end_data - (u_int64_t)start_data);
     boot_map_segment(vpt2, start_data, (u_int64_t)end_data - (u_int64_t)start_data, start_data, PTE_R | PTE_W);
-    printf(".data mapped!\n");
+    klog_debug(".data mapped!\n");
 
-    printf(".kern_stk need:0x%lx B\n", (u_int64_t)end_kern_stk - (u_int64_t)start_kern_stk);
+    klog_debug(".kern_stk need:0x%lx B\n", (u_int64_t)end_kern_stk - (u_int64_t)start_kern_stk);
     boot_map_segment(vpt2, start_kern_stk, (u_int64_t)end_kern_stk - (u_int64_t)start_kern_stk, start_kern_stk, PTE_R | PTE_W);
-    printf(".kern_stk mapped!\n");
+    klog_debug(".kern_stk mapped!\n");
 
     /************* Page directory set, address below are virtual address **************/
 
@@ -345,7 +348,7 @@ printf(".data need:0x%lx B\n", (u_int64_t)end_data - (u_int64_t)start_data);
      * physical address `pages` allocated before. For consideration of alignment,
      * you should round up the memory size before map. */
     pages = (struct Page *)alloc(npage * sizeof(struct Page), BY2PG, 1);
-    printf("to memory %lx for struct Pages.\n", freemem);
+    klog_debug("to memory %lx for struct Pages.\n", freemem);
     n = ROUND(npage * sizeof(struct Page), BY2PG);
     boot_map_segment(vpt2, UPAGES, n, pages, PTE_R | PTE_W);
     pages_paddr = pages;
@@ -359,17 +362,22 @@ printf(".data need:0x%lx B\n", (u_int64_t)end_data - (u_int64_t)start_data);
     envs_paddr = envs;
     envs = UENVS;
 
+    /* Step 4: map the PLIC and the UART registers at KDEV for the
+     * console input driver (lib/cons.c). */
+    boot_map_segment(vpt2, PLIC, PLIC_SIZE, PLIC_PA, PTE_R | PTE_W);
+    boot_map_segment(vpt2, UART0, BY2PG, UART0_PA, PTE_R | PTE_W);
+
 	u_int64_t tmpva = 0x090000000;
     boot_map_segment(vpt2, tmpva, BY2PG, tmpva, PTE_R | PTE_W);
-	printf("TEST:%lx->%lx\n", tmpva, tmpva);
+	klog_debug("TEST:%lx->%lx\n", tmpva, tmpva);
 	test_vaddr_map(vpt2, tmpva, tmpva);
     boot_unmap(vpt2, tmpva);
-	printf("TEST:%lx->%lx\n", tmpva, tmpva);
+	klog_debug("TEST:%lx->%lx\n", tmpva, tmpva);
 	test_vaddr_map(vpt2, tmpva, tmpva);
 
-printf("ready to set vpt at vpt2: %lx, ppn: %lx\n", vpt2, PPN(vpt2));
+klog_debug("ready to set vpt at vpt2: %lx, ppn: %lx\n", vpt2, PPN(vpt2));
 
-	printf("TEST:%lx->%lx\n", start_text, start_text);
+	klog_debug("TEST:%lx->%lx\n", start_text, start_text);
 	test_vaddr_map(vpt2, start_text, start_text);
 //	printf("TEST:%lx->%lx\n", start_data, start_data);
 //	test_vaddr_map(vpt2, start_data, start_data);
@@ -379,8 +387,8 @@ printf("ready to set vpt at vpt2: %lx, ppn: %lx\n", vpt2, PPN(vpt2));
     /* Set up VPT register. */
     n = set_vpt2(MODE_SV39, 0, PPN(vpt2));
 
-    printf("pmap.c:\t risc-v vm init success\n");
-	printf("TEST:%lx->%lx\n", start_text, start_text);
+    klog_info("pmap.c:\t risc-v vm init success\n");
+	klog_debug("TEST:%lx->%lx\n", start_text, start_text);
 	test_vaddr_map(vpt2, start_text, start_text);
 }
 
@@ -395,25 +403,25 @@ page_init(void)
 {
     /* Step 1: Initialize page_free_list. */
     /* Hint: Use macro `LIST_INIT` defined in include/queue.h. */
-printf("Enter page_init!\n");
+klog_debug("Enter page_init!\n");
     LIST_INIT(&page_free_list);
-printf("Page_init list_init end!\n");
+klog_debug("Page_init list_init end!\n");
     /* Step 2: Align `freemem` up to multiple of BY2PG. */
     freemem = ROUND(freemem, BY2PG);
-printf("Page_init freemem_round end!\n");
+klog_debug("Page_init freemem_round end!\n");
     /* Step 3: Mark all memory blow `freemem` as used(set `pp_ref`
      * filed to 1) */
     int cur;
     for (cur = 0; cur < PPN(PADDR2ACTMEM(freemem)); cur++) {
         pages[cur].pp_ref = 1;
     }
-printf("Page_init used pages[] init end!\n");
+klog_debug("Page_init used pages[] init end!\n");
     /* Step 4: Mark the other memory as free. */
     for (cur = PPN(PADDR2ACTMEM(freemem)); cur < npage; cur++) {
         pages[cur].pp_ref = 0;
         LIST_INSERT_HEAD(&page_free_list, &pages[cur], pp_link);
     }
-printf("End of page_init!\n");
+klog_debug("End of page_init!\n");
 }
 
 // Overview:
@@ -434,7 +442,7 @@ int
 page_alloc(struct Page **pp)
 {
     struct Page *ppage_temp;
-printf("page_alloc() start!\n");
+klog_debug("page_alloc() start!\n");
 
     /* Step 1: Get a page from free memory. If fails, return the error code.*/
     if (LIST_EMPTY(&page_free_list)) {
@@ -466,7 +474,7 @@ printf("page_alloc() start!\n");
 
     bzero(page_va, BY2PG);
     boot_unmap(boot_vpt2, page_va);
-printf("page_alloc() success with page paddr: %lx, struct va:%lx!\n", page2pa(*pp), *pp);
+klog_debug("page_alloc() success with page paddr: %lx, struct va:%lx!\n", page2pa(*pp), *pp);
     return 0;
 
 }
@@ -499,7 +507,7 @@ page_free(struct Page *pp)
 //	table rooted at vpt2.
 void page_map_vpt(Pte *vpt2, Pte *vpt)
 {
-printf("vpt map start\n");
+klog_debug("vpt map start\n");
 	struct Page *ppage;
 	u_int64_t va = (u_int64_t)vpt, pte, base;
 	Pte *vpt1, *vpt1_ent, *vpt0, *vpt0_ent;
@@ -507,7 +515,7 @@ printf("vpt map start\n");
 	base = VPN2(vpt) << PT2SHIFT;
 	//printf("vpt2_ent:0x%lx\n", vpt2+VPN2(va));
 	if ((vpt2[VPN2(va)] & PTE_V) == 0) {
-printf("vpt1 new!!!!!\n");
+klog_debug("vpt1 new!!!!!\n");
 		vpt1_new = 1;
 		if(page_alloc(&ppage) == -E_NO_MEM) {
 			return -E_NO_MEM;
@@ -518,12 +526,12 @@ printf("vpt1 new!!!!!\n");
 		vpt2[VPN2(va)] = PADDR_TO_PTE(vpt1) | PTE_V;
 		tlb_invalidate(vpt2, vpt1);
 		
-printf("vpt:%lx, base1:%lx\n", vpt, base);
+klog_debug("vpt:%lx, base1:%lx\n", vpt, base);
 		u_int64_t down = ((u_int64_t)vpt) & 0xffffffffc0000000;
 		u_int64_t up = down + 0x40000000;
 		if (((VPN1(vpt) << PT1SHIFT + base) <= vpt1) &&(((VPN1(vpt) + 1) << PT1SHIFT + base) > vpt1)) {
 			// Self mapping!!!
-			printf("Self mapping1!\n");
+			klog_debug("Self mapping1!\n");
 			Pte *va_tmp = 0x090000000;
 			page_insert(vpt2, ppage, va_tmp, PTE_R | PTE_W);
 			ppage->pp_ref++;
@@ -539,33 +547,33 @@ printf("vpt:%lx, base1:%lx\n", vpt, base);
 	}
 	//printf("vpt1_ent:0x%lx\n", vpt1+VPN1(va));
 	if ((vpt1[VPN1(va)] & PTE_V) == 0) {
-printf("vpt0 new!!!!!\n");
+klog_debug("vpt0 new!!!!!\n");
 		vpt0_new = 1;
 		if(page_alloc(&ppage) == -E_NO_MEM) {
-			printf("NO MEMORY!!\n");
+			klog_err("NO MEMORY!!\n");
 			return -E_NO_MEM;
 			// No memory.
 		}
 		vpt0 = page2pa(ppage);
-printf("vpt0 paddr:%lx\n", vpt0);
+klog_debug("vpt0 paddr:%lx\n", vpt0);
 //		page_map_vpt(vpt2, vpt0);
 		vpt1[VPN1(va)] = PADDR_TO_PTE(vpt0) | PTE_V;
 		tlb_invalidate(vpt2, vpt0);
-		printf("base:%lx\n", base);
+		klog_debug("base:%lx\n", base);
 		base += VPN1(vpt) << PT1SHIFT;
 		u_int64_t down = ((u_int64_t)vpt) & 0xffffffffffe00000;
 		u_int64_t up = down + 0x200000;
-		if (vpt0 == 0x087fff000) {printf("0x87fff000, range:%lx - %lx\n", down, up);}
-		if ((u_int64_t)vpt0 >= down) {printf(">= ");}
-		if ((u_int64_t)vpt0 < up) {printf("< ");}
+		if (vpt0 == 0x087fff000) {klog_debug("0x87fff000, range:%lx - %lx\n", down, up);}
+		if ((u_int64_t)vpt0 >= down) {klog_debug(">= ");}
+		if ((u_int64_t)vpt0 < up) {klog_debug("< ");}
 		if ((down <= (u_int64_t)vpt0) && (up > (u_int64_t)vpt0)) {
 			// Self mapping!!!
-			printf("Self mapping2!\n");
+			klog_debug("Self mapping2!\n");
 			Pte *va_tmp = 0x090000000;
 			page_insert(vpt2, ppage, va_tmp, PTE_R | PTE_W);
 			ppage->pp_ref++;
 			*(va_tmp + VPN0(vpt0)) = PADDR_TO_PTE(vpt0) | PTE_V | PTE_R | PTE_W;
-			printf("write:%lx, addr:%lx, paddr:%lx\n", *(va_tmp + VPN0(vpt0)), (va_tmp + VPN0(vpt0)), vpt0);
+			klog_debug("write:%lx, addr:%lx, paddr:%lx\n", *(va_tmp + VPN0(vpt0)), (va_tmp + VPN0(vpt0)), vpt0);
 			page_remove(vpt2, va_tmp);
 			ppage->pp_ref--;
 			tlb_invalidate(vpt2, vpt0);
@@ -576,10 +584,10 @@ printf("vpt0 paddr:%lx\n", vpt0);
 test_vaddr_map(vpt2, vpt0, vpt0);
 		page_map_vpt(vpt2, vpt0);
 	}
-printf("vpt map1, vpt0:%lx\n", vpt0);
+klog_debug("vpt map1, vpt0:%lx\n", vpt0);
 test_vaddr_map(vpt2, vpt0, vpt0);
 vpt0[0]=0x10086;
-printf("vpt map2, %lx\n",vpt0[0]);
+klog_debug("vpt map2, %lx\n",vpt0[0]);
 	//printf("vpt0_ent:0x%lx\n", vpt0+VPN0(va));
 	//printf("%d, %d, %lx\n", vpt1_new, vpt0_new, &vpt0[VPN0(va)]);
 	vpt0[VPN0(va)] = PADDR_TO_PTE(va) | PTE_V | PTE_R | PTE_W;
@@ -590,7 +598,7 @@ printf("vpt map2, %lx\n",vpt0[0]);
 	if (vpt0_new) {
 		boot_map_vpt(vpt2, vpt0);
 	}*/
-printf("vpt map succ\n");
+klog_debug("vpt map succ\n");
 }
 
 // Overview:
@@ -657,6 +665,8 @@ vpt2_walk(Pte *vpt2, u_int64_t va, int create, Pte **vpt0e)
 	return 0;
 }
 
+static void tlb_invalidate_batch(Pte *vpt2, u_int64_t va);
+
 // Overview:
 // 	Map the physical page 'pp' at virtual address 'va'.
 // 	The permissions (the low 12 bits) of the page table entry should be set to 'perm|PTE_V'.
@@ -668,8 +678,9 @@ vpt2_walk(Pte *vpt2, u_int64_t va, int create, Pte **vpt0e)
 // Hint:
 //	If there is already a page mapped at `va`, call page_remove() to release this mapping.
 //	The `pp_ref` should be incremented if the insertion succeeds.
-int
-page_insert(Pte *vpt2, struct Page *pp, u_int64_t va, u_int perm)
+static int
+page_insert_tlb(Pte *vpt2, struct Page *pp, u_int64_t va, u_int perm,
+                void (*invalidate)(Pte *, u_int64_t))
 {
     u_int PERM;
     Pte *vpt0_entry;
@@ -689,7 +700,7 @@ page_insert(Pte *vpt2, struct Page *pp, u_int64_t va, u_int perm)
         } else  {
 //printf("sit2\n");
             *vpt0_entry = (PADDR_TO_PTE(page2pa(pp)) | PERM);
-	    tlb_invalidate(vpt2, va);
+	    invalidate(vpt2, va);
             return 0;
         }
     }
@@ -698,7 +709,7 @@ page_insert(Pte *vpt2, struct Page *pp, u_int64_t va, u_int perm)
     /* Step 2: Update TLB. */
 
     /* hint: use tlb_invalidate function */
-    tlb_invalidate(vpt2, va);
+    invalidate(vpt2, va);
 
     /* Step 3: Do check, re-get page table entry to validate the insertion. */
 
@@ -709,13 +720,28 @@ page_insert(Pte *vpt2, struct Page *pp, u_int64_t va, u_int perm)
 //printf("walk2 complete!\n");
     /* Step 3.2 Insert page and increment the pp_ref */
     *vpt0_entry = (PADDR_TO_PTE(page2pa(pp)) | PERM);
-    tlb_invalidate(vpt2, va);
+    invalidate(vpt2, va);
 //printf("refill complete!pp:%lx, pp->ref:%lx\n", pp, &pp->pp_ref);
     pp->pp_ref += 1;
 //printf("ref succ\n");
     return 0;
 }
 
+int
+page_insert(Pte *vpt2, struct Page *pp, u_int64_t va, u_int perm)
+{
+    return page_insert_tlb(vpt2, pp, va, perm, tlb_invalidate);
+}
+
+// Overview:
+// 	page_insert() whose TLB flush for `va` waits for tlb_batch_end().
+// 	Page tables it has to allocate are still flushed at once.
+int
+page_insert_batch(Pte *vpt2, struct Page *pp, u_int64_t va, u_int perm)
+{
+    return page_insert_tlb(vpt2, pp, va, perm, tlb_invalidate_batch);
+}
+
 // Overview:
 //	Look up the Page that virtual address `va` map to.
 //
@@ -783,6 +809,9 @@ page_remove(Pte *vpt2, u_int64_t va)
 //printf("rm:ref ok\n");
     if (ppage->pp_ref == 0) {
         page_free(ppage);
+    } else {
+        /* Waits on this page may depend on its reference count. */
+        futex_wake_page(page2pa(ppage));
     }
 
     /* Step 3: Update TLB. */
@@ -791,6 +820,29 @@ page_remove(Pte *vpt2, u_int64_t va)
     return;
 }
 
+static int tlb_batch_depth;	// nested tlb_batch_begin() calls
+static int tlb_batch_pending;	// a flush was deferred
+
+// Overview:
+// 	Defer the flushes of page_insert_batch() until the matching
+// 	tlb_batch_end(), which then flushes once for all of them. Plain
+// 	tlb_invalidate() is never deferred: the kernel may go through the
+// 	mapping it just changed (page_alloc's temporary one, say).
+void
+tlb_batch_begin(void)
+{
+	tlb_batch_depth++;
+}
+
+void
+tlb_batch_end(void)
+{
+	if (--tlb_batch_depth == 0 && tlb_batch_pending) {
+		tlb_batch_pending = 0;
+		tlb_out(0);
+	}
+}
+
 // Overview:
 // 	Update TLB.
 void
@@ -803,13 +855,23 @@ tlb_invalidate(Pte *vpt2, u_int64_t va)
 	//}
 }
 
+static void
+tlb_invalidate_batch(Pte *vpt2, u_int64_t va)
+{
+	if (tlb_batch_depth > 0) {
+		tlb_batch_pending = 1;
+		return;
+	}
+	tlb_invalidate(vpt2, va);
+}
+
 void
 physical_memory_manage_check(void)
 {
     struct Page *pp, *pp0, *pp1, *pp2;
     struct Page_list fl;
     int *temp;
-    printf("Start physical_memory_manage_check()\n");
+    klog_info("Start physical_memory_manage_check()\n");
 
     // should be able to allocate three pages
     pp0 = pp1 = pp2 = 0;
@@ -850,17 +912,17 @@ physical_memory_manage_check(void)
     page_free(pp2);
     struct Page_list test_free;
     struct Page *test_pages;
-printf("mark0\n");
+klog_debug("mark0\n");
 //freemem = freemem - (pages_paddr - pages);
 //freemem = ROUND(freemem, BY2PG);
 struct Page *tmppage1, *tmppage2;
 page_alloc(&tmppage1);
 //page_alloc(&tmppage2);
-printf("tmppage struct addr : %lx\n", tmppage1);
+klog_debug("tmppage struct addr : %lx\n", tmppage1);
 page_insert(boot_vpt2, tmppage1, page2pa(tmppage1), PTE_R|PTE_W);
 //page_insert(boot_vpt2, tmppage2, page2pa(tmppage2), PTE_R|PTE_W);
 test_pages = page2pa(tmppage1);
-printf("mark1\n");
+klog_debug("mark1\n");
         //test_pages= (struct Page *)alloc(10 * sizeof(struct Page), BY2PG, 1);
         LIST_INIT(&test_free);
         //LIST_FIRST(&test_free) = &test_pages[0];
@@ -875,7 +937,7 @@ printf("mark1\n");
                 //printf("0x%x  0x%x\n",&test_pages[i], test_pages[i].pp_link.le_next);
 
         }
-printf("mark2\n");
+klog_debug("mark2\n");
         p = LIST_FIRST(&test_free);
         int answer1[]={0,1,2,3,4,5,6,7,8,9};
         assert(p!=NULL);
@@ -887,7 +949,7 @@ printf("mark2\n");
                 p=LIST_NEXT(p,pp_link);
 
         }
-printf("mark3\n");
+klog_debug("mark3\n");
         // insert_after test
         int answer2[]={0,1,2,3,4,20,5,6,7,8,9};
         q=(struct Page *)alloc(sizeof(struct Page), BY2PG, 1);
@@ -907,7 +969,7 @@ printf("mark3\n");
 
 
 
-    printf("physical_memory_manage_check() succeeded\n");
+    klog_info("physical_memory_manage_check() succeeded\n");
 }
 
 void
@@ -1009,7 +1071,7 @@ page_check(void)
 	page_free(pp1);
 	page_free(pp2);
 
-	printf("page_check() succeeded!\n");
+	klog_info("page_check() succeeded!\n");
 }
 
 void pageout(int va, int context)
@@ -1036,61 +1098,61 @@ void pageout(int va, int context)
 	p->pp_ref++;
 
 	page_insert((Pde *)context, p, VA2PFN(va), PTE_R);
-	printf("pageout:\t@@@___0x%x___@@@  ins a page \n", va);
+	klog_debug("pageout:\t@@@___0x%x___@@@  ins a page \n", va);
 }
 
 void test_vaddr_map(Pte *vpt2, u_int64_t va, u_int64_t pa) {
-	printf("TEST: 0x%lx -> 0x%lx\n", va, pa);
+	klog_debug("TEST: 0x%lx -> 0x%lx\n", va, pa);
 	Pte *vpt2_ent, *vpt1, *vpt1_ent, *vpt0, *vpt0_ent;
 	u_int64_t i, pte_value;
-	printf("PADDR of VPT2:%lx\n", vpt2);
+	klog_debug("PADDR of VPT2:%lx\n", vpt2);
 	i = VPN2(va);
 	vpt2_ent = vpt2 + i;
-	printf("VPT2_ENT ADDR:%lx\n", vpt2_ent);
+	klog_debug("VPT2_ENT ADDR:%lx\n", vpt2_ent);
 	pte_value = *vpt2_ent;
-	printf("VPT2_ENTRY:%lx\n", pte_value);
-	printf("PADDR of VPT1:%lx\n", PTE_TO_PADDR(pte_value));
-	if ((pte_value & PTE_V) == 0) {printf("VPTENT invalid!\n");return;}
+	klog_debug("VPT2_ENTRY:%lx\n", pte_value);
+	klog_debug("PADDR of VPT1:%lx\n", PTE_TO_PADDR(pte_value));
+	if ((pte_value & PTE_V) == 0) {klog_debug("VPTENT invalid!\n");return;}
 	if (((pte_value & PTE_R) == 0) && ((pte_value & PTE_W) == 1)) {
-		printf("VPT ENT NOT READABLE but WRITABLE");
+		klog_debug("VPT ENT NOT READABLE but WRITABLE");
 		return;
 	}
 	vpt1 = (Pte *)PTE_TO_PADDR(pte_value);
 	i = VPN1(va);
 	vpt1_ent = vpt1 + i;
-	printf("VPT1_ENT ADDR:%lx\n", vpt1_ent);
+	klog_debug("VPT1_ENT ADDR:%lx\n", vpt1_ent);
 	pte_value = *vpt1_ent;
-	printf("VPT1_ENTRY:%lx\n", pte_value);
-	printf("PADDR of VPT0:%lx\n", PTE_TO_PADDR(pte_value));
-	if ((pte_value & PTE_V) == 0) {printf("VPTENT invalid!\n");return;}
+	klog_debug("VPT1_ENTRY:%lx\n", pte_value);
+	klog_debug("PADDR of VPT0:%lx\n", PTE_TO_PADDR(pte_value));
+	if ((pte_value & PTE_V) == 0) {klog_debug("VPTENT invalid!\n");return;}
 	if (((pte_value & PTE_R) == 0) && ((pte_value & PTE_W) == 1)) {
-		printf("VPT ENT NOT READABLE but WRITABLE");
+		klog_debug("VPT ENT NOT READABLE but WRITABLE");
 		return;
 	}
 	vpt0 = (Pte *)(Pte *)PTE_TO_PADDR(pte_value);
 	i = VPN0(va);
 	vpt0_ent = vpt0 + i;
-	printf("VPT0_ENT ADDR:%lx\n", vpt0_ent);
+	klog_debug("VPT0_ENT ADDR:%lx\n", vpt0_ent);
 	pte_value = *vpt0_ent;
-	printf("VPT0_ENTRY:%lx\n", pte_value);
-	printf("Perm:");
-	if ((pte_value & PTE_V)!=0){printf(" Valid ");}
-	if ((pte_value & PTE_R)!=0){printf(" Read ");}
-	if ((pte_value & PTE_W)!=0){printf(" Write ");}
-	if ((pte_value & PTE_X)!=0){printf(" Execute ");}
-	if ((pte_value & PTE_U)!=0){printf(" User ");}
-	printf("\n");
-	if ((pte_value & PTE_V) == 0) {printf("VPTENT invalid!\n");return;}
+	klog_debug("VPT0_ENTRY:%lx\n", pte_value);
+	klog_debug("Perm:");
+	if ((pte_value & PTE_V)!=0){klog_debug(" Valid ");}
+	if ((pte_value & PTE_R)!=0){klog_debug(" Read ");}
+	if ((pte_value & PTE_W)!=0){klog_debug(" Write ");}
+	if ((pte_value & PTE_X)!=0){klog_debug(" Execute ");}
+	if ((pte_value & PTE_U)!=0){klog_debug(" User ");}
+	klog_debug("\n");
+	if ((pte_value & PTE_V) == 0) {klog_debug("VPTENT invalid!\n");return;}
 	if (((pte_value & PTE_R) == 0) && ((pte_value & PTE_W) == 1)) {
-		printf("VPT ENT NOT READABLE but WRITABLE");
+		klog_debug("VPT ENT NOT READABLE but WRITABLE");
 		return;
 	}
 	
 	va = PTE_TO_PADDR(pte_value);
 	pa = pa & ~0xfff;
-	printf("va:%lx\npa:%lx\n", va, pa);
+	klog_debug("va:%lx\npa:%lx\n", va, pa);
 	if (va == pa){
-		printf("TEST SUCCESS!\n");
+		klog_debug("TEST SUCCESS!\n");
 	}
 	return;
 }
@@ -0,0 +1,146 @@
+/*
+ * Host-side microbenchmark of the include/queue.h macros.
+ *
+ * Times appending N elements and rotating them (remove the head,
+ * append it again, as the round-robin scheduler does on every slice
+ * expiry) with LIST, TAILQ and CIRCLEQ.
+ *
+ * Build and run on the host:
+ *	make -C tools/queuebench run
+ *
+ * Output is one line per test: "queuebench: <queue> <op> n=<n> ns/op=<t>".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../include/queue.h"
+
+struct node {
+	LIST_ENTRY(node) l_link;
+	TAILQ_ENTRY(node) t_link;
+	CIRCLEQ_ENTRY(node) c_link;
+	int val;
+};
+
+LIST_HEAD(node_list, node);
+TAILQ_HEAD(node_tailq, node);
+CIRCLEQ_HEAD(node_circleq, node);
+
+static double
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void
+report(const char *queue, const char *op, int n, long ops, double ns)
+{
+	printf("queuebench: %s %s n=%d ns/op=%.1f\n", queue, op, n, ns / ops);
+}
+
+static void
+bench_list(struct node *nodes, int n, int rounds)
+{
+	struct node_list head;
+	struct node *e;
+	double t;
+	int i;
+
+	LIST_INIT(&head);
+	t = now_ns();
+	for (i = 0; i < n; i++) {
+		LIST_INSERT_TAIL(&head, &nodes[i], l_link);
+	}
+	report("LIST", "insert_tail", n, n, now_ns() - t);
+
+	t = now_ns();
+	for (i = 0; i < rounds; i++) {
+		e = LIST_FIRST(&head);
+		LIST_REMOVE(e, l_link);
+		LIST_INSERT_TAIL(&head, e, l_link);
+	}
+	report("LIST", "rotate", n, rounds, now_ns() - t);
+}
+
+static void
+bench_tailq(struct node *nodes, int n, int rounds)
+{
+	struct node_tailq head;
+	struct node *e;
+	double t;
+	int i;
+
+	TAILQ_INIT(&head);
+	t = now_ns();
+	for (i = 0; i < n; i++) {
+		TAILQ_INSERT_TAIL(&head, &nodes[i], t_link);
+	}
+	report("TAILQ", "insert_tail", n, n, now_ns() - t);
+
+	t = now_ns();
+	for (i = 0; i < rounds; i++) {
+		e = TAILQ_FIRST(&head);
+		TAILQ_REMOVE(&head, e, t_link);
+		TAILQ_INSERT_TAIL(&head, e, t_link);
+	}
+	report("TAILQ", "rotate", n, rounds, now_ns() - t);
+
+	if (TAILQ_LAST(&head, node_tailq) != &nodes[(rounds - 1) % n]) {
+		printf("queuebench: TAILQ order broken\n");
+		exit(1);
+	}
+}
+
+static void
+bench_circleq(struct node *nodes, int n, int rounds)
+{
+	struct node_circleq head;
+	struct node *e;
+	double t;
+	int i;
+
+	CIRCLEQ_INIT(&head);
+	t = now_ns();
+	for (i = 0; i < n; i++) {
+		CIRCLEQ_INSERT_TAIL(&head, &nodes[i], c_link);
+	}
+	report("CIRCLEQ", "insert_tail", n, n, now_ns() - t);
+
+	t = now_ns();
+	for (i = 0; i < rounds; i++) {
+		e = CIRCLEQ_FIRST(&head);
+		CIRCLEQ_REMOVE(&head, e, c_link);
+		CIRCLEQ_INSERT_TAIL(&head, e, c_link);
+	}
+	report("CIRCLEQ", "rotate", n, rounds, now_ns() - t);
+
+	if (CIRCLEQ_LAST(&head) != &nodes[(rounds - 1) % n]) {
+		printf("queuebench: CIRCLEQ order broken\n");
+		exit(1);
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	static const int sizes[] = { 16, 256, 1024, 4096 };
+	struct node *nodes;
+	int i, n, rounds = 100000;
+
+	if (argc > 1) {
+		rounds = atoi(argv[1]);
+	}
+	for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+		n = sizes[i];
+		nodes = calloc(n, sizeof(*nodes));
+		bench_list(nodes, n, rounds);
+		bench_tailq(nodes, n, rounds);
+		bench_circleq(nodes, n, rounds);
+		free(nodes);
+	}
+	return 0;
+}
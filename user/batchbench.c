@@ -0,0 +1,110 @@
+// Batched-syscall benchmark: build and tear down an address space
+// region of NPAGES pages with one syscall_mem_alloc/_unmap per page,
+// then with the same calls queued on a sysring and run by one
+// sysring_enter each way. Prints the cycles per page for both, then
+// checks that a batch reports a failing entry.
+
+#include "lib.h"
+#include <kclock.h>
+
+#define NPAGES		SYSRING_ENTRIES
+#define ROUNDS		20
+#define SYSRING_VA	0x50000000
+#define REGION_VA	0x48000000
+
+static struct Sysring *sr = (struct Sysring *)SYSRING_VA;
+
+static void
+report(char *kind, u_int64_t cycles)
+{
+	writef("batchbench: kind=%s pages=%d rounds=%d cycles_per_page=%ld\n",
+		   kind, NPAGES, ROUNDS, (long)(cycles / (NPAGES * ROUNDS)));
+}
+
+// Run everything queued and check that all of it succeeded.
+static void
+run_batch(void)
+{
+	struct Sysring_cqe cqe;
+	int n;
+
+	if ((n = sysring_enter(sr, 0)) != NPAGES || sr->sr_errors != 0) {
+		user_panic("batchbench: batch ran %d, %d failed", n, sr->sr_errors);
+	}
+	while (sysring_reap(sr, &cqe))
+		;
+}
+
+static void
+bench_single(void)
+{
+	u_int64_t start;
+	int i, j;
+
+	start = get_cycle();
+	for (i = 0; i < ROUNDS; i++) {
+		for (j = 0; j < NPAGES; j++) {
+			syscall_mem_alloc(0, REGION_VA + j * BY2PG, PTE_V | PTE_R);
+		}
+		for (j = 0; j < NPAGES; j++) {
+			syscall_mem_unmap(0, REGION_VA + j * BY2PG);
+		}
+	}
+	report("single", get_cycle() - start);
+}
+
+static void
+bench_batch(void)
+{
+	u_int64_t start;
+	int i, j;
+
+	start = get_cycle();
+	for (i = 0; i < ROUNDS; i++) {
+		for (j = 0; j < NPAGES; j++) {
+			sysring_prep(sr, j, SYS_mem_alloc, 0, REGION_VA + j * BY2PG,
+						 PTE_V | PTE_R, 0, 0);
+		}
+		run_batch();
+		for (j = 0; j < NPAGES; j++) {
+			sysring_prep(sr, j, SYS_mem_unmap, 0, REGION_VA + j * BY2PG,
+						 0, 0, 0);
+		}
+		run_batch();
+	}
+	report("batch", get_cycle() - start);
+}
+
+// A bad entry in the middle: with SYSRING_STOP the batch ends there
+// and the entry after it is still queued.
+static void
+check_errors(void)
+{
+	struct Sysring_cqe cqe;
+	int n;
+
+	sysring_prep(sr, 0, SYS_mem_alloc, 0, REGION_VA, PTE_V | PTE_R, 0, 0);
+	sysring_prep(sr, 1, SYS_mem_alloc, 0, UTOP, PTE_V | PTE_R, 0, 0);
+	sysring_prep(sr, 2, SYS_mem_unmap, 0, REGION_VA, 0, 0, 0);
+	n = sysring_enter(sr, SYSRING_STOP);
+	writef("batchbench: stop ran=%d errors=%d first_error=%d queued=%d\n",
+		   n, sr->sr_errors, sr->sr_first_error,
+		   sr->sr_sq_tail - sr->sr_sq_head);
+	while (sysring_reap(sr, &cqe)) {
+		writef("batchbench: entry=%ld ret=%d\n", (long)cqe.cq_data, cqe.cq_ret);
+	}
+	sysring_enter(sr, 0);
+	while (sysring_reap(sr, &cqe))
+		;
+}
+
+void
+umain(void)
+{
+	if (sysring_open(sr) < 0) {
+		user_panic("batchbench: sysring_open failed");
+	}
+	bench_single();
+	bench_batch();
+	check_errors();
+}
@@ -0,0 +1,26 @@
+// Latency statistics shared by the benchmarks.
+
+#include "lib.h"
+
+// Sort the n (> 0) samples at s in place and take their min, median,
+// 99th percentile and max. A shell sort: no recursion, no extra memory.
+void
+bench_stats(u_int64_t *s, int n, struct Bench_stats *st)
+{
+	int gap, i, j;
+	u_int64_t v;
+
+	for (gap = n / 2; gap > 0; gap /= 2) {
+		for (i = gap; i < n; i++) {
+			v = s[i];
+			for (j = i; j >= gap && s[j - gap] > v; j -= gap) {
+				s[j] = s[j - gap];
+			}
+			s[j] = v;
+		}
+	}
+	st->min = s[0];
+	st->median = s[n / 2];
+	st->p99 = s[n * 99 / 100];
+	st->max = s[n - 1];
+}
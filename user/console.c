@@ -59,9 +59,7 @@ cons_read(struct Fd *fd, void *vbuf, u_int n, u_int offset)
 		return 0;
 	}
 
-	while ((c = syscall_cgetc()) == 0) {
-		syscall_yield();
-	}
+	c = syscall_cons_read();	// sleeps until a key arrives
 
 	if (c != '\r') {
 		writef("%c", c);
@@ -84,26 +82,15 @@ cons_read(struct Fd *fd, void *vbuf, u_int n, u_int offset)
 int
 cons_write(struct Fd *fd, const void *vbuf, u_int n, u_int offset)
 {
-	int tot, m;
-	char buf[128];
+	int r;
 
 	USED(offset);
 
-	// mistake: have to nul-terminate arg to syscall_cputs,
-	// so we have to copy vbuf into buf in chunks and nul-terminate.
-	for (tot = 0; tot < n; tot += m) {
-		m = n - tot;
-
-		if (m > sizeof buf - 1) {
-			m = sizeof buf - 1;
-		}
-
-		user_bcopy((char *)vbuf + tot, buf, m);
-		buf[m] = 0;
-		writef("%s", buf);
+	// one trap for the whole buffer
+	if ((r = syscall_console_write(vbuf, n)) < 0) {
+		return r;
 	}
-
-	return tot;
+	return n;
 }
 
 int
@@ -0,0 +1,41 @@
+// Context-switch cost benchmark.
+// Two envs bounce the cpu with directed yields; ctxbench times the
+// round trips and reads the kernel's per-env switch cycles from envs[].
+// Start ctxbench, then ctxpeer right after it; the peer is found in
+// envs[CTX_PEER].
+
+#include "lib.h"
+#include <kclock.h>
+
+#define ROUNDS		1000
+#define CTX_PEER	1	// envs[] slot of ctxpeer
+
+void
+umain(void)
+{
+	u_int me, peer, i;
+	u_int64_t start, total, sw, runs;
+	struct Env *e;
+
+	me = syscall_getenvid();
+	peer = envs[CTX_PEER].env_id;
+
+	// let the peer reach its loop first
+	syscall_yield_to(peer);
+
+	e = &envs[ENVX(me)];
+	sw = e->env_switch_cycles;
+	runs = e->env_runs;
+	start = get_cycle();
+	for (i = 0; i < ROUNDS; i++) {
+		syscall_yield_to(peer);
+	}
+	total = get_cycle() - start;
+	sw = e->env_switch_cycles - sw;
+	runs = e->env_runs - runs;
+
+	writef("ctxbench: rounds=%d cycles/rt=%ld switches=%ld "
+		   "switch_cycles=%ld cycles/switch=%ld\n",
+		   ROUNDS, (long)(total / ROUNDS), (long)runs, (long)sw,
+		   (long)(runs ? sw / runs : 0));
+}
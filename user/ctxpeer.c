@@ -0,0 +1,13 @@
+// Peer of the context-switch benchmark (user/ctxbench.c). Hands the
+// cpu straight back to ctxbench in envs[CTX_BENCH] until that is gone.
+
+#include "lib.h"
+
+#define CTX_BENCH	0	// envs[] slot of ctxbench
+
+void
+umain(void)
+{
+	while (syscall_yield_to(envs[CTX_BENCH].env_id) == 0)
+		;
+}
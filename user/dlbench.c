@@ -0,0 +1,37 @@
+// Deadline reservation check for SCHED_EDF. Reserves RUNTIME cycles in
+// every PERIOD, spins for DURATION cycles and reports the share of the
+// cpu it got; the clock tick throttles it once a period's budget is
+// spent. Then the kernel prints its edf wakeup latency histogram.
+
+#include "lib.h"
+#include <kclock.h>
+
+#define RUNTIME		2000000		// cycles of budget per period
+#define PERIOD		10000000	// cycles
+#define DURATION	200000000UL	// cycles to spin for
+
+void
+umain(void)
+{
+	struct Kdata kd;
+	u_int64_t end, ran;
+	int r;
+
+	if ((r = syscall_set_deadline(0, RUNTIME, PERIOD, PERIOD)) < 0) {
+		writef("dlbench: reservation refused: %d\n", r);
+		return;
+	}
+	kdata_read(&kd);
+	ran = kd.kd_runtime;
+	end = get_cycle() + DURATION;
+	while (get_cycle() < end)
+		;
+	syscall_yield();	// refresh kd_runtime
+	kdata_read(&kd);
+	ran = kd.kd_runtime - ran;
+
+	writef("dlbench: reserved=%d%% got=%d%% ran=%ld cycles=%ld\n",
+		   RUNTIME * 100 / PERIOD, (int)(ran * 100 / DURATION),
+		   (long)ran, (long)DURATION);
+	syscall_sysstat(SYSSTAT_DL_DUMP, 0, 0);
+}
@@ -0,0 +1,25 @@
+// Worker of user/eptest.c: eptest binds it to its endpoint and then
+// sends the endpoint id; from then on it answers every call with its
+// own envid.
+
+#include "lib.h"
+
+void
+umain(void)
+{
+	u_int ep, who, me;
+
+	ep = ipc_recv(&who, 0, 0);
+	if (env->env_ep_bound != ep) {
+		user_panic("epserver: not bound to %x", ep);
+	}
+	// only the owner may grant serving
+	if (syscall_ep_bind(ep, 0) != -E_INVAL) {
+		user_panic("epserver: bound itself to %x", ep);
+	}
+	me = getenvid();
+	ipc_reply_recv(0, 0, 0, 0, &who, 0, 0);
+	for (;;) {
+		ipc_reply_recv(who, me, 0, 0, &who, 0, 0);
+	}
+}
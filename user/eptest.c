@@ -0,0 +1,55 @@
+// Endpoint test: calls spread over several servers. Start it first and
+// NSERVER epservers right after it, so they sit in envs[1..NSERVER].
+// It binds them to an endpoint it owns, makes NCALL ep_calls, and checks that
+// each was answered and that every server took its share; then it
+// prints "eptest: ok".
+
+#include "lib.h"
+
+#define NSERVER		3
+#define NCALL		30
+
+void
+umain(void)
+{
+	u_int ep, who;
+	int count[NSERVER], i, j, r;
+
+	if ((r = syscall_ep_alloc()) < 0) {
+		user_panic("eptest: ep_alloc: %d", r);
+	}
+	ep = r;
+	for (i = 0; i < NSERVER; i++) {
+		count[i] = 0;
+		if ((r = syscall_ep_bind(ep, envs[1 + i].env_id)) < 0) {
+			user_panic("eptest: ep_bind: %d", r);
+		}
+		ipc_send(envs[1 + i].env_id, ep, 0, 0);
+	}
+	// let every server block in its receive first
+	for (i = 0; i < NSERVER; i++) {
+		while (envs[1 + i].env_ep_bound != ep ||
+			   envs[1 + i].env_status != ENV_NOT_RUNNABLE) {
+			syscall_yield();
+		}
+	}
+
+	// each server answers with its own envid
+	for (i = 0; i < NCALL; i++) {
+		who = ep_call(ep, i, 0, 0, 0, 0);
+		for (j = 0; j < NSERVER && envs[1 + j].env_id != who; j++)
+			;
+		if (j == NSERVER) {
+			user_panic("eptest: call %d answered by %x", i, who);
+		}
+		count[j]++;
+	}
+	for (i = 0; i < NSERVER; i++) {
+		writef("eptest: server=%x calls=%d\n", envs[1 + i].env_id, count[i]);
+		if (count[i] == 0) {
+			user_panic("eptest: server %x was never called",
+					   envs[1 + i].env_id);
+		}
+	}
+	writef("eptest: ok\n");
+}
@@ -0,0 +1,38 @@
+// Fairness benchmark for the SCHED_FAIR class.
+// Runs CPU-bound envs of different weights next to an IPC-bound
+// ping-pong pair for a fixed number of cycles, then prints how the
+// cpu was shared. The workers are fbcpu and fbipc, started by the
+// kernel in the slots given in fairbench.h.
+
+#include "lib.h"
+#include <kclock.h>
+#include "fairbench.h"
+
+static void
+report(char *kind, u_int id, u_int work)
+{
+	struct Env *e = &envs[ENVX(id)];
+
+	writef("fairbench: kind=%s env=%x pri=%d work=%d runtime=%ld runs=%d\n",
+		   kind, id, e->env_pri, work, (long)e->env_runtime, e->env_runs);
+}
+
+void
+umain(void)
+{
+	u_int who, work;
+	int i;
+
+	syscall_set_sched(0, SCHED_FAIR, 1);
+
+	// pong must have its go before ping starts sending, so go from
+	// the last slot down
+	for (i = FB_IPC + 1; i >= FB_CPU; i--) {
+		ipc_send(envs[i].env_id, 0, 0, 0);
+	}
+
+	for (i = 0; i < FB_NCPU + 2; i++) {
+		work = ipc_recv(&who, 0, 0);
+		report(ENVX(who) < FB_IPC ? "cpu" : "ipc", who, work);
+	}
+}
@@ -0,0 +1,16 @@
+// envs[] layout of the fairness benchmark. Start fairbench, FB_NCPU
+// fbcpus and two fbipcs in this order, so each finds the others by
+// slot; see init/init.c.
+
+#ifndef _FAIRBENCH_H_
+#define _FAIRBENCH_H_
+
+#define FB_DRIVER	0		// envs[] slot of fairbench
+#define FB_CPU		1		// slot of the first fbcpu
+#define FB_NCPU		3
+#define FB_IPC		(FB_CPU + FB_NCPU)	// the ping side; pong is next
+#define FB_CPU_PRI(slot)	(1 << ((slot) - FB_CPU))	// weights 1, 2, 4
+#define FB_DURATION	200000000UL	// cycles each worker runs for
+#define FB_STOP		0xffffffff
+
+#endif
@@ -0,0 +1,18 @@
+// Client of the fan-in benchmark (user/fanin.c). Makes FI_NREQ
+// request/reply round trips to the server in envs[FI_SERVER].
+
+#include "lib.h"
+#include "fanin.h"
+
+void
+umain(void)
+{
+	u_int srv, who;
+	int i;
+
+	srv = envs[FI_SERVER].env_id;
+	for (i = 0; i < FI_NREQ; i++) {
+		ipc_send(srv, i, 0, 0);
+		ipc_recv_from(srv, &who, 0, 0);
+	}
+}
@@ -0,0 +1,29 @@
+// Many-clients-one-server IPC throughput benchmark.
+// FI_NCLIENT envs each make FI_NREQ request/reply round trips to one
+// server. Waiting senders are queued in the kernel, so they use no cpu
+// while the server is busy. The server reports requests served per
+// cycle. The clients are fanclient, started by the kernel after this
+// one in the slots given in fanin.h.
+
+#include "lib.h"
+#include <kclock.h>
+#include "fanin.h"
+
+void
+umain(void)
+{
+	u_int who, v;
+	u_int64_t start, total;
+	int n;
+
+	start = get_cycle();
+	for (n = 0; n < FI_NCLIENT * FI_NREQ; n++) {
+		v = ipc_recv(&who, 0, 0);
+		ipc_send(who, v, 0, 0);
+	}
+	total = get_cycle() - start;
+
+	writef("fanin: clients=%d requests=%d cycles=%ld cycles/req=%ld\n",
+		   FI_NCLIENT, FI_NCLIENT * FI_NREQ, (long)total,
+		   (long)(total / (FI_NCLIENT * FI_NREQ)));
+}
@@ -0,0 +1,11 @@
+// envs[] layout of the fan-in benchmark. Start fanin, then FI_NCLIENT
+// fanclients, so the clients find the server by slot; see init/init.c.
+
+#ifndef _FANIN_H_
+#define _FANIN_H_
+
+#define FI_SERVER	0		// envs[] slot of fanin
+#define FI_NCLIENT	8
+#define FI_NREQ		200		// round trips each fanclient makes
+
+#endif
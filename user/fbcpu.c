@@ -0,0 +1,22 @@
+// CPU-bound worker of the fairness benchmark (user/fairbench.c).
+// Takes a weight from its slot, spins from the go message for
+// FB_DURATION cycles and reports how many loops it got through.
+
+#include "lib.h"
+#include <kclock.h>
+#include "fairbench.h"
+
+void
+umain(void)
+{
+	u_int who, work = 0;
+	u_int64_t end;
+
+	syscall_set_sched(0, SCHED_FAIR, FB_CPU_PRI(ENVX(syscall_getenvid())));
+	ipc_recv(&who, 0, 0);
+	end = get_cycle() + FB_DURATION;
+	while (get_cycle() < end) {
+		work++;
+	}
+	ipc_send(who, work, 0, 0);
+}
@@ -0,0 +1,33 @@
+// IPC-bound worker of the fairness benchmark (user/fairbench.c). Two
+// of these ping-pong a null message for FB_DURATION cycles from the go
+// message; the one in slot FB_IPC serves first.
+
+#include "lib.h"
+#include <kclock.h>
+#include "fairbench.h"
+
+void
+umain(void)
+{
+	u_int drv, who, peer, rounds = 0;
+	u_int64_t end;
+	int ping;
+
+	ping = ENVX(syscall_getenvid()) == FB_IPC;
+	peer = envs[ping ? FB_IPC + 1 : FB_IPC].env_id;
+	ipc_recv(&drv, 0, 0);
+	end = get_cycle() + FB_DURATION;
+
+	if (ping) {
+		ipc_send(peer, 0, 0, 0);
+	}
+	while (ipc_recv(&who, 0, 0) != FB_STOP) {
+		rounds++;
+		if (get_cycle() >= end) {
+			ipc_send(peer, FB_STOP, 0, 0);
+			break;
+		}
+		ipc_send(peer, 0, 0, 0);
+	}
+	ipc_send(drv, rounds, 0, 0);
+}
@@ -6,6 +6,10 @@
 
 extern u_char fsipcbuf[BY2PG];		// page-aligned, declared in entry.S
 
+// The file server is envs[1]. If it serves an endpoint, calls go there
+// instead, to be picked up by any of its idle workers.
+#define fsipc_ep()	(envs[1].env_ep_bound)
+
 // Send an IP request to the file server, and wait for a reply.
 // type: request code, passed as the simple integer IPC value.
 // fsreq: page to send containing additional request data, usually fsipcbuf.
@@ -16,12 +20,16 @@ extern u_char fsipcbuf[BY2PG];		// page-aligned, declared in entry.S
 static int
 fsipc(u_int type, void *fsreq, u_int dstva, u_int *perm)
 {
-	u_int whom;
 	int r;
 	//we file system no. is 000000000000000000
-	ipc_send(envs[1].env_id, type, (u_int)fsreq, PTE_V | PTE_R);
-	//	writef("fsipc:ending ipc send & recv dst:%x\n",dstva);
-	r =  ipc_recv(&whom, dstva, perm);
+	// one syscall: send the request, switch to the server, get the reply
+	if (fsipc_ep() != 0) {
+		r = ep_call(fsipc_ep(), type, (u_int)fsreq, PTE_V | PTE_R,
+					dstva, perm);
+	} else {
+		r = ipc_call(envs[1].env_id, type, (u_int)fsreq, PTE_V | PTE_R,
+					 dstva, perm);
+	}
 	//writef("fsipc:r = %d\n",r);
 	return r;
 }
@@ -77,16 +85,26 @@ fsipc_map(u_int fileid, u_int offset, u_int dstva)
 	return 0;
 }
 
+// Send a request small enough for a register message: its fields go
+// in mr[] and no page is mapped. Returns the server's reply value.
+static int
+fsipc_mr(u_int type, u_int n, u_int64_t *mr)
+{
+	if (fsipc_ep() != 0) {
+		return ep_call_mr(fsipc_ep(), type, n, mr);
+	}
+	return ipc_call_mr(envs[1].env_id, type, n, mr);
+}
+
 // Make a set-file-size request to the file server.
 int
 fsipc_set_size(u_int fileid, u_int size)
 {
-	struct Fsreq_set_size *req;
+	u_int64_t mr[IPC_MR_WORDS];
 
-	req = (struct Fsreq_set_size *)fsipcbuf;
-	req->req_fileid = fileid;
-	req->req_size = size;
-	return fsipc(FSREQ_SET_SIZE, req, 0, 0);
+	mr[0] = fileid;
+	mr[1] = size;
+	return fsipc_mr(FSREQ_SET_SIZE, 2, mr);
 }
 
 // Make a file-close request to the file server.
@@ -94,23 +112,21 @@ fsipc_set_size(u_int fileid, u_int size)
 int
 fsipc_close(u_int fileid)
 {
-	struct Fsreq_close *req;
+	u_int64_t mr[IPC_MR_WORDS];
 
-	req = (struct Fsreq_close *)fsipcbuf;
-	req->req_fileid = fileid;
-	return fsipc(FSREQ_CLOSE, req, 0, 0);
+	mr[0] = fileid;
+	return fsipc_mr(FSREQ_CLOSE, 1, mr);
 }
 
 // Ask the file server to mark a particular file block dirty.
 int
 fsipc_dirty(u_int fileid, u_int offset)
 {
-	struct Fsreq_dirty *req;
+	u_int64_t mr[IPC_MR_WORDS];
 
-	req = (struct Fsreq_dirty *)fsipcbuf;
-	req->req_fileid = fileid;
-	req->req_offset = offset;
-	return fsipc(FSREQ_DIRTY, req, 0, 0);
+	mr[0] = fileid;
+	mr[1] = offset;
+	return fsipc_mr(FSREQ_DIRTY, 2, mr);
 }
 
 // Ask the file server to delete a file, given its pathname.
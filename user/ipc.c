@@ -6,22 +6,14 @@
 
 extern struct Env *env;
 
-// Send val to whom.  This function keeps trying until
-// it succeeds.  It should panic() on any error other than
-// -E_IPC_NOT_RECV.
-//
-// Hint: use syscall_yield() to be CPU-friendly.
+// Send val to whom. This blocks in the kernel, queued behind any other
+// senders, until whom receives it. It should panic() on any error.
 void
 ipc_send(u_int whom, u_int val, u_int srcva, u_int perm)
 {
 	int r;
 
-	while ((r = syscall_ipc_can_send(whom, val, srcva, perm)) == -E_IPC_NOT_RECV) {
-		syscall_yield();
-		//writef("QQ");
-	}
-
-	if (r == 0) {
+	if ((r = syscall_ipc_send(whom, val, srcva, perm)) == 0) {
 		return;
 	}
 
@@ -35,8 +27,155 @@ ipc_send(u_int whom, u_int val, u_int srcva, u_int perm)
 u_int
 ipc_recv(u_int *whom, u_int dstva, u_int *perm)
 {
-	//printf("ipc_recv:come 0\n");
-	syscall_ipc_recv(dstva);
+	return ipc_recv_from(0, whom, dstva, perm);
+}
+
+// Receive the reply to a request sent to server. Until it arrives the
+// server runs with our priority if that is higher than its own.
+u_int
+ipc_recv_from(u_int server, u_int *whom, u_int dstva, u_int *perm)
+{
+	syscall_ipc_recv_from(dstva, server);
+
+	if (whom) {
+		*whom = env->env_ipc_from;
+	}
+
+	if (perm) {
+		*perm = env->env_ipc_perm;
+	}
+
+	return env->env_ipc_value;
+}
+
+
+// Send val (and the page at srcva) to whom and wait for its reply, in a
+// single syscall. Returns the reply value; a reply page is mapped at
+// dstva and its permissions stored in *rperm.
+u_int
+ipc_call(u_int whom, u_int val, u_int srcva, u_int perm, u_int dstva,
+		 u_int *rperm)
+{
+	int r;
+
+	if ((r = syscall_ipc_call(whom, val, srcva, perm, dstva)) < 0) {
+		user_panic("error in ipc_call: %d", r);
+	}
+
+	if (rperm) {
+		*rperm = env->env_ipc_perm;
+	}
+
+	return env->env_ipc_value;
+}
+
+// Server loop step: answer the client whom (0 for none) with val, then
+// receive the next request. Returns its value and stores the client in
+// *from.
+u_int
+ipc_reply_recv(u_int whom, u_int val, u_int srcva, u_int perm,
+			   u_int *from, u_int dstva, u_int *rperm)
+{
+	int r;
+
+	if ((r = syscall_ipc_reply_recv(whom, val, srcva, perm, dstva)) < 0) {
+		user_panic("error in ipc_reply_recv: %d", r);
+	}
+
+	if (from) {
+		*from = env->env_ipc_from;
+	}
+
+	if (rperm) {
+		*rperm = env->env_ipc_perm;
+	}
+
+	return env->env_ipc_value;
+}
+
+// ipc_call with a register message and no page: sends n words of mr[]
+// (room for IPC_MR_WORDS) and overwrites mr[] with the reply's words.
+// Returns the reply value.
+u_int
+ipc_call_mr(u_int whom, u_int val, u_int n, u_int64_t *mr)
+{
+	int r;
+	u_int i;
+
+	if ((r = syscall_ipc_call_mr(whom, val, n, mr)) < 0) {
+		user_panic("error in ipc_call_mr: %d", r);
+	}
+
+	for (i = 0; i < env->env_ipc_mr_len; i++) {
+		mr[i] = env->env_ipc_mr[i];
+	}
+
+	return env->env_ipc_value;
+}
+
+// Block until notification object id is signalled; return the bits
+// that were pending, all of which are now taken.
+u_int
+notif_wait(u_int id)
+{
+	int r;
+
+	if ((r = syscall_notif_wait(id, 0, 0)) < 0) {
+		user_panic("error in notif_wait: %d", r);
+	}
+
+	return env->env_notif_bits;
+}
+
+// Wait for either a signal on notification object id or an IPC message
+// at dstva. Returns 1 with *bits set for a signal, or 0 with *whom and
+// *perm set as ipc_recv does for a message; the value is in
+// env->env_ipc_value.
+int
+notif_wait_recv(u_int id, u_int *bits, u_int *whom, u_int dstva, u_int *perm)
+{
+	int r;
+
+	if ((r = syscall_notif_wait(id, 1, dstva)) < 0) {
+		user_panic("error in notif_wait_recv: %d", r);
+	}
+
+	if (r == NOTIF_WOKEN) {
+		if (bits) {
+			*bits = env->env_notif_bits;
+		}
+		return 1;
+	}
+	if (whom) {
+		*whom = env->env_ipc_from;
+	}
+	if (perm) {
+		*perm = env->env_ipc_perm;
+	}
+	return 0;
+}
+
+// Send val and the npages pages from srcva to whom in one message.
+void
+ipc_send_pages(u_int whom, u_int val, u_int srcva, u_int npages, u_int perm)
+{
+	int r;
+
+	if ((r = syscall_ipc_send_pages(whom, val, srcva, npages, perm)) < 0) {
+		user_panic("error in ipc_send_pages: %d", r);
+	}
+}
+
+// Receive a message granting up to npages pages, mapped from dstva on;
+// env->env_ipc_npages says how many came.
+u_int
+ipc_recv_pages(u_int *whom, u_int dstva, u_int npages, u_int *perm)
+{
+	int r;
+
+	if ((r = syscall_ipc_recv_pages(dstva, npages)) < 0) {
+		user_panic("error in ipc_recv_pages: %d", r);
+	}
 
 	if (whom) {
 		*whom = env->env_ipc_from;
@@ -49,3 +188,40 @@ ipc_recv(u_int *whom, u_int dstva, u_int *perm)
 	return env->env_ipc_value;
 }
 
+// ipc_call to endpoint ep: whichever of its servers is idle answers.
+// Servers just loop on ipc_reply_recv once the endpoint's owner has
+// bound them with syscall_ep_bind(ep, envid).
+u_int
+ep_call(u_int ep, u_int val, u_int srcva, u_int perm, u_int dstva,
+		u_int *rperm)
+{
+	int r;
+
+	if ((r = syscall_ep_call(ep, val, srcva, perm, dstva)) < 0) {
+		user_panic("error in ep_call: %d", r);
+	}
+
+	if (rperm) {
+		*rperm = env->env_ipc_perm;
+	}
+
+	return env->env_ipc_value;
+}
+
+// ipc_call_mr to endpoint ep.
+u_int
+ep_call_mr(u_int ep, u_int val, u_int n, u_int64_t *mr)
+{
+	int r;
+	u_int i;
+
+	if ((r = syscall_ep_call_mr(ep, val, n, mr)) < 0) {
+		user_panic("error in ep_call_mr: %d", r);
+	}
+
+	for (i = 0; i < env->env_ipc_mr_len; i++) {
+		mr[i] = env->env_ipc_mr[i];
+	}
+
+	return env->env_ipc_value;
+}
@@ -1,6 +1,9 @@
 #ifndef LIB_H
 #define LIB_H
 #include "fd.h"
+#include "ring.h"
+#include <sysring.h>
+#include <sysstat.h>
 #include "pmap.h"
 #include <mmu.h>
 #include <trap.h>
@@ -15,6 +18,12 @@ extern void exit();
 
 extern struct Env *env;
 
+// kernel data page at UKDATA, read without a syscall
+u_int getenvid(void);
+u_int getparentid(void);
+u_int64_t gettimebase(void);
+void kdata_read(struct Kdata *kd);
+
 
 #define USED(x) (void)(x)
 //////////////////////////////////////////////////////printf
@@ -43,6 +52,7 @@ void user_bcopy(const void *src, void *dst, size_t len);
 void user_bzero(void *v, u_int n);
 //////////////////////////////////////////////////syscall_lib
 extern int msyscall(int, int, int, int, int, int);
+extern int msyscall_mr(int, int, int, int, int, int, u_int, u_int64_t *);
 
 void syscall_putchar(char ch);
 u_int syscall_getenvid(void);
@@ -64,8 +74,44 @@ int syscall_set_env_status(u_int envid, u_int status);
 int syscall_set_trapframe(u_int envid, struct Trapframe *tf);
 void syscall_panic(char *msg);
 int syscall_ipc_can_send(u_int envid, u_int value, u_int srcva, u_int perm);
+int syscall_ipc_send(u_int envid, u_int value, u_int srcva, u_int perm);
+int syscall_ipc_call(u_int envid, u_int value, u_int srcva, u_int perm,
+					 u_int dstva);
+int syscall_ipc_reply_recv(u_int envid, u_int value, u_int srcva, u_int perm,
+						   u_int dstva);
+int syscall_ipc_send_mr(u_int envid, u_int value, u_int n, u_int64_t *mr);
+int syscall_ipc_call_mr(u_int envid, u_int value, u_int n, u_int64_t *mr);
+int syscall_ipc_reply_recv_mr(u_int envid, u_int value, u_int n,
+							  u_int64_t *mr, u_int dstva);
 void syscall_ipc_recv(u_int dstva);
+int syscall_notif_alloc(void);
+int syscall_notif_free(u_int id);
+int syscall_notif_signal(u_int id, u_int bits);
+int syscall_notif_wait(u_int id, u_int recv, u_int dstva);
+int syscall_futex_wait(u_int va, u_int expected, u_int timeout);
+int syscall_futex_wake(u_int va, u_int n);
+int syscall_ipc_recv_pages(u_int dstva, u_int npages);
+int syscall_ep_alloc(void);
+int syscall_ep_bind(u_int id, u_int envid);
+int syscall_ep_call(u_int id, u_int value, u_int srcva, u_int perm,
+					u_int dstva);
+int syscall_ep_call_mr(u_int id, u_int value, u_int n, u_int64_t *mr);
+int syscall_ipc_send_pages(u_int envid, u_int value, u_int srcva,
+						   u_int npages, u_int perm);
+int syscall_ipc_send_sg(u_int envid, u_int value, u_int nseg, u_int64_t *segs,
+						u_int perm);
+void syscall_ipc_recv_from(u_int dstva, u_int server);
 int syscall_cgetc();
+int syscall_cons_read(void);
+int syscall_console_write(const char *buf, u_int len);
+int syscall_set_sched(u_int envid, u_int class, u_int pri);
+int syscall_set_deadline(u_int envid, u_int runtime, u_int period,
+						 u_int deadline);
+int syscall_yield_to(u_int envid);
+int syscall_set_affinity(u_int envid, u_int hartmask);
+int syscall_sysring_setup(u_int va);
+int syscall_sysring_enter(u_int flags);
+int syscall_sysstat(u_int op, u_int arg, u_int dstva);
 
 // string.c
 int strlen(const char *s);
@@ -77,6 +123,21 @@ int strcmp(const char *p, const char *q);
 // ipc.c
 void	ipc_send(u_int whom, u_int val, u_int srcva, u_int perm);
 u_int	ipc_recv(u_int *whom, u_int dstva, u_int *perm);
+u_int	ipc_recv_from(u_int server, u_int *whom, u_int dstva, u_int *perm);
+u_int	ipc_call(u_int whom, u_int val, u_int srcva, u_int perm, u_int dstva,
+				 u_int *rperm);
+u_int	ipc_reply_recv(u_int whom, u_int val, u_int srcva, u_int perm,
+					   u_int *from, u_int dstva, u_int *rperm);
+u_int	ipc_call_mr(u_int whom, u_int val, u_int n, u_int64_t *mr);
+void	ipc_send_pages(u_int whom, u_int val, u_int srcva, u_int npages,
+					   u_int perm);
+u_int	ipc_recv_pages(u_int *whom, u_int dstva, u_int npages, u_int *perm);
+u_int	ep_call(u_int ep, u_int val, u_int srcva, u_int perm, u_int dstva,
+				u_int *rperm);
+u_int	ep_call_mr(u_int ep, u_int val, u_int n, u_int64_t *mr);
+u_int	notif_wait(u_int id);
+int		notif_wait_recv(u_int id, u_int *bits, u_int *whom, u_int dstva,
+						u_int *perm);
 
 // wait.c
 void wait(u_int envid);
@@ -89,6 +150,47 @@ int iscons(int fdnum);
 int pipe(int pfd[2]);
 int pipeisclosed(int fdnum);
 
+// ring.c
+int	ring_create(u_int va, u_int npages);
+int	ring_attach(struct Ring *r, int side);
+int	ring_send(struct Ring *r, const void *buf, u_int len);
+int	ring_recv(struct Ring *r, void *buf, u_int max);
+
+// sysring.c
+int	sysring_open(struct Sysring *sr);
+int	sysring_prep(struct Sysring *sr, u_int64_t data, u_int sysno,
+			 u_int a0, u_int a1, u_int a2, u_int a3, u_int a4);
+int	sysring_enter(struct Sysring *sr, u_int flags);
+int	sysring_reap(struct Sysring *sr, struct Sysring_cqe *cqe);
+
+// bench.c
+struct Bench_stats {
+	u_int64_t min;
+	u_int64_t median;
+	u_int64_t p99;
+	u_int64_t max;
+};
+
+void	bench_stats(u_int64_t *s, int n, struct Bench_stats *st);
+
+// sync.c
+struct Mutex {
+	volatile u_int m_state;
+};
+
+struct Cond {
+	volatile u_int c_seq;
+};
+
+void	mutex_init(struct Mutex *m);
+void	mutex_lock(struct Mutex *m);
+int		mutex_trylock(struct Mutex *m);
+void	mutex_unlock(struct Mutex *m);
+void	cond_init(struct Cond *c);
+void	cond_wait(struct Cond *c, struct Mutex *m);
+void	cond_signal(struct Cond *c);
+void	cond_broadcast(struct Cond *c);
+
 // pageref.c
 int	pageref(void *);
 
@@ -9,6 +9,41 @@ exit(void)
 	syscall_env_destroy(0);
 }
 
+static struct Kdata *kdata = (struct Kdata *)UKDATA;
+
+u_int
+getenvid(void)
+{
+	return kdata->kd_envid;
+}
+
+u_int
+getparentid(void)
+{
+	return kdata->kd_parent_id;
+}
+
+u_int64_t
+gettimebase(void)
+{
+	return kdata->kd_timebase_hz;
+}
+
+// Copy a consistent snapshot of the kernel data page into *kd,
+// retrying while the kernel is in the middle of an update.
+void
+kdata_read(struct Kdata *kd)
+{
+	u_int seq;
+
+	do {
+		while ((seq = kdata->kd_seq) & 1)
+			;
+		asm volatile("fence r, r" ::: "memory");
+		*kd = *kdata;
+		asm volatile("fence r, r" ::: "memory");
+	} while (kdata->kd_seq != seq);
+}
 
 struct Env *env;
 
@@ -19,7 +54,7 @@ libmain(int argc, char **argv)
 	env = 0;	// Your code here.
 	//writef("xxxxxxxxx %x  %x  xxxxxxxxx\n",argc,(int)argv);
 	int envid;
-	envid = syscall_getenvid();
+	envid = getenvid();
 	envid = ENVX(envid);
 	env = &envs[envid];
 	// call user main routine
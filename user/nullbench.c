@@ -0,0 +1,52 @@
+// Null-syscall benchmark for the syscall entry/exit path.
+// Times single calls with rdcycle and prints min/median/p99 cycles for
+//   getenvid  the cheapest real syscall
+//   bad       an out-of-range number: entry, dispatch check and return
+//   kdata     getenvid() from the UKDATA page, no trap at all
+// in the same "key=value" format as pingpong.
+
+#include "lib.h"
+#include <kclock.h>
+
+#define ROUNDS	1000
+
+static u_int64_t samples[ROUNDS];
+
+static void
+report(char *test)
+{
+	struct Bench_stats st;
+
+	bench_stats(samples, ROUNDS, &st);
+	writef("nullbench: test=%s n=%d min=%ld median=%ld p99=%ld\n",
+		   test, ROUNDS, (long)st.min, (long)st.median, (long)st.p99);
+}
+
+void
+umain(void)
+{
+	u_int64_t t;
+	int i;
+
+	syscall_getenvid();	// warm up
+	for (i = 0; i < ROUNDS; i++) {
+		t = get_cycle();
+		syscall_getenvid();
+		samples[i] = get_cycle() - t;
+	}
+	report("getenvid");
+
+	for (i = 0; i < ROUNDS; i++) {
+		t = get_cycle();
+		msyscall(__SYSCALL_BASE + __NR_SYSCALLS, 0, 0, 0, 0, 0);
+		samples[i] = get_cycle() - t;
+	}
+	report("bad");
+
+	for (i = 0; i < ROUNDS; i++) {
+		t = get_cycle();
+		getenvid();
+		samples[i] = get_cycle() - t;
+	}
+	report("kdata");
+}
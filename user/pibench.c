@@ -0,0 +1,53 @@
+// Priority inheritance benchmark.
+// A high-priority client makes requests to a low-priority server while
+// CPU hogs of middle priority compete for the cpu. Request latency is
+// measured first with a plain ipc_recv, then with ipc_recv_from, which
+// lends the server the client's priority while it works on the reply.
+// For SCHED_FAIR that priority is a weight: the server accrues virtual
+// runtime more slowly, it does not jump ahead of the hogs at once.
+// The server is pisrv and the hogs are pihog, started by the kernel in
+// the slots given in pibench.h; the hogs stop once pibench exits.
+
+#include "lib.h"
+#include <kclock.h>
+#include "pibench.h"
+
+#define NREQ		100
+
+static u_int64_t lat[NREQ];
+
+static void
+run(char *mode, u_int srv, int pi)
+{
+	struct Bench_stats st;
+	u_int who;
+	u_int64_t start;
+	int i;
+
+	for (i = 0; i < NREQ; i++) {
+		start = get_cycle();
+		ipc_send(srv, i, 0, 0);
+		if (pi) {
+			ipc_recv_from(srv, &who, 0, 0);
+		} else {
+			ipc_recv(&who, 0, 0);
+		}
+		lat[i] = get_cycle() - start;
+	}
+	bench_stats(lat, NREQ, &st);
+	writef("pibench: mode=%s n=%d min=%ld median=%ld p99=%ld max=%ld\n",
+		   mode, NREQ, (long)st.min, (long)st.median, (long)st.p99,
+		   (long)st.max);
+}
+
+void
+umain(void)
+{
+	u_int srv;
+
+	syscall_set_sched(0, SCHED_FAIR, 8);
+	srv = envs[PI_SERVER].env_id;
+
+	run("plain", srv, 0);
+	run("pi", srv, 1);
+}
@@ -0,0 +1,13 @@
+// envs[] layout of the priority inheritance benchmark. Start pibench,
+// pisrv and PI_NHOG pihogs in this order, so each finds the others by
+// slot; see init/init.c.
+
+#ifndef _PIBENCH_H_
+#define _PIBENCH_H_
+
+#define PI_BENCH	0		// envs[] slot of pibench
+#define PI_SERVER	1		// slot of pisrv
+#define PI_HOG		2		// slot of the first pihog
+#define PI_NHOG		3
+
+#endif
@@ -0,0 +1,26 @@
+// Middle-weight cpu hog of the priority inheritance benchmark
+// (user/pibench.c). Burns the cpu until pibench has exited, but yields
+// now and then so the others still get picked when the clock tick is
+// not preempting anyone.
+
+#include "lib.h"
+#include <kclock.h>
+#include "pibench.h"
+
+#define HOG_WORK	1000000UL	// cycles a hog spins between yields
+
+void
+umain(void)
+{
+	struct Env *b = &envs[PI_BENCH];
+	u_int bench = b->env_id;
+	u_int64_t end;
+
+	syscall_set_sched(0, SCHED_FAIR, 4);
+	while (b->env_status != ENV_FREE && b->env_id == bench) {
+		end = get_cycle() + HOG_WORK;
+		while (get_cycle() < end)
+			;
+		syscall_yield();
+	}
+}
@@ -1,39 +1,108 @@
-// Ping-pong a counter between two processes.
-// Only need to start one of these -- splits into two with fork.
+// IPC benchmark suite. Times single round trips with rdcycle and
+// reports min/median/p99 cycles, plus messages per second of wall time:
+//   reg    ipc_call carrying a full register message, no page
+//   page   ipc_call granting one page
+//   fanin  PP_NCLIENT ppclients calling the server at once
+// One line per test, "pingpong: test=<name> key=value ...", then
+// "pingpong: done". The echo server and the clients are separate
+// programs (ppserver, ppclient) started next to this one by `make
+// bench`; user/pingpong.h says where each one is.
 
 #include "lib.h"
+#include <kclock.h>
+#include "pingpong.h"
 
-void
-umain(void)
+#define ROUNDS		(PP_NCLIENT * PP_NREQ)
+
+static u_int64_t samples[ROUNDS];
+static char page[BY2PG] __attribute__((aligned(BY2PG)));
+
+static void
+report(char *test, u_int64_t *s, int n, u_int64_t ticks)
 {
-	u_int who, i;
+	struct Bench_stats st;
 
-	if ((who = fork()) != 0) {
-		// get the ball rolling
-		writef("\n@@@@@send 0 from %x to %x\n", syscall_getenvid(), who);
-		ipc_send(who, 0, 0, 0);
-		//user_panic("&&&&&&&&&&&&&&&&&&&&&&&&m");
-	}
+	bench_stats(s, n, &st);
+	writef("pingpong: test=%s n=%d min=%ld median=%ld p99=%ld msgs_per_sec=%ld\n",
+		   test, n, (long)st.min, (long)st.median, (long)st.p99,
+		   (long)(2ULL * n * TIMEBASE_HZ / (ticks ? ticks : 1)));
+}
 
-	for (;;) {
-		writef("%x am waiting.....\n", syscall_getenvid());
-		i = ipc_recv(&who, 0, 0);
+static void
+bench_reg(u_int srv)
+{
+	u_int64_t mr[IPC_MR_WORDS], t, ticks;
+	int i;
 
-		writef("%x got %d from %x\n", syscall_getenvid(), i, who);
+	for (i = 0; i < IPC_MR_WORDS; i++) {
+		mr[i] = i;
+	}
+	ipc_call_mr(srv, 0, IPC_MR_WORDS, mr);	// warm up
+	ticks = get_time();
+	for (i = 0; i < ROUNDS; i++) {
+		t = get_cycle();
+		ipc_call_mr(srv, i, IPC_MR_WORDS, mr);
+		samples[i] = get_cycle() - t;
+	}
+	report("reg", samples, ROUNDS, get_time() - ticks);
+}
 
-		//user_panic("&&&&&&&&&&&&&&&&&&&&&&&&&&&&&");
-		if (i == 10) {
-			return;
-		}
+static void
+bench_page(u_int srv)
+{
+	u_int64_t t, ticks;
+	int i;
 
-		i++;
-		writef("\n@@@@@send %d from %x to %x\n",i, syscall_getenvid(), who);
-		ipc_send(who, i, 0, 0);
+	page[0] = 1;	// fault it in before timing
+	ipc_call(srv, 0, (u_int)page, PTE_V | PTE_R, 0, 0);
+	ticks = get_time();
+	for (i = 0; i < ROUNDS; i++) {
+		t = get_cycle();
+		ipc_call(srv, i, (u_int)page, PTE_V | PTE_R, 0, 0);
+		samples[i] = get_cycle() - t;
+	}
+	report("page", samples, ROUNDS, get_time() - ticks);
+}
+
+// Each client gets its own sample page; they are gathered into
+// samples[] once all have reported.
+static void
+bench_fanin(void)
+{
+	u_int64_t ticks;
+	u_int who;
+	int c;
 
-		if (i == 10) {
-			return;
+	for (c = 0; c < PP_NCLIENT; c++) {
+		if (syscall_mem_alloc(0, PP_SAMPLE_VA + c * BY2PG, PTE_V | PTE_R) < 0) {
+			user_panic("pingpong: no memory for samples");
 		}
 	}
 
+	ticks = get_time();
+	for (c = 0; c < PP_NCLIENT; c++) {
+		ipc_send(envs[PP_CLIENT + c].env_id, c, PP_SAMPLE_VA + c * BY2PG,
+				 PTE_V | PTE_R);
+	}
+	for (c = 0; c < PP_NCLIENT; c++) {
+		ipc_recv(&who, 0, 0);
+	}
+	ticks = get_time() - ticks;
+	for (c = 0; c < PP_NCLIENT; c++) {
+		user_bcopy((void *)(PP_SAMPLE_VA + c * BY2PG), &samples[c * PP_NREQ],
+				   PP_NREQ * sizeof(u_int64_t));
+	}
+	report("fanin", samples, ROUNDS, ticks);
 }
 
+void
+umain(void)
+{
+	u_int srv = envs[PP_SERVER].env_id;
+
+	bench_reg(srv);
+	bench_page(srv);
+	bench_fanin();
+	writef("pingpong: done\n");
+	syscall_env_destroy(srv);
+}
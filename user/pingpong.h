@@ -0,0 +1,15 @@
+// envs[] layout of the IPC benchmark suite. `make bench` starts
+// pingpong, ppserver and PP_NCLIENT ppclients in this order, so each
+// finds the others by slot; see init/init.c.
+
+#ifndef _PINGPONG_H_
+#define _PINGPONG_H_
+
+#define PP_SERVER	1		// envs[] slot of ppserver
+#define PP_CLIENT	2		// slot of the first ppclient
+#define PP_NCLIENT	4
+#define PP_NREQ		250		// calls each ppclient makes
+#define PP_PAGE_VA	0x48000000	// where ppserver takes granted pages
+#define PP_SAMPLE_VA	0x50000000	// where a ppclient gets its sample page
+
+#endif
@@ -20,11 +20,15 @@ struct Dev devpipe = {
 #define BY2PIPE 32		// small to provoke races
 
 struct Pipe {
-	u_int p_rpos;		    // read position
-	u_int p_wpos;		    // write position
+	volatile u_int p_rpos;	// read position
+	volatile u_int p_wpos;	// write position
+	volatile u_int p_rwait;	// reader sleeps on p_wpos
+	volatile u_int p_wwait;	// writer sleeps on p_rpos
 	u_char p_buf[BY2PIPE];	// data buffer
 };
 
+#define pipe_fence()	__asm__ __volatile__("fence rw, rw" ::: "memory")
+
 int
 pipe(int pfd[2])
 {
@@ -94,8 +98,39 @@ _pipeisclosed(struct Fd *fd, struct Pipe *p)
 	int pfd, pfp, runs;
 
     /*Step 1: Get reference of fd and p, and check if they are the same. */
+	do {
+		runs = env->env_runs;
+		pfd = pageref(fd);
+		pfp = pageref(p);
+	} while (runs != env->env_runs);
 
     /*Step 2: If they are the same, return 1; otherwise return 0. */
+	return pfd == pfp;
+}
+
+/* Overview:
+ *  Sleep until *pos moves away from `seen`, or the other end goes
+ *  away: unmapping the pipe page wakes every futex waiter on it.
+ *  `flag` tells the other end to wake us after it moves *pos.
+ */
+static void
+pipe_wait(volatile u_int *flag, volatile u_int *pos, u_int seen)
+{
+	*flag = 1;
+	pipe_fence();
+	syscall_futex_wait((u_int)pos, seen, 0);
+	*flag = 0;
+}
+
+// Wake the other end if it sleeps on *pos, which we just moved.
+static void
+pipe_wake(volatile u_int *flag, volatile u_int *pos)
+{
+	pipe_fence();
+	if (*flag) {
+		*flag = 0;
+		syscall_futex_wake((u_int)pos, 1);
+	}
 }
 
 int
@@ -134,10 +169,24 @@ piperead(struct Fd *fd, void *vbuf, u_int n, u_int offset)
 	char *rbuf;
 
     /*Step 1: Get the pipe p according to fd. And vbuf is the reading buffer. */
+	p = (struct Pipe *)fd2data(fd);
+	rbuf = vbuf;
+
+    /*Step 2: If pointer of reading is ahead of writing, then wait. */
+	while (p->p_rpos == p->p_wpos) {
+		if (_pipeisclosed(fd, p)) {
+			return 0;
+		}
+		pipe_wait(&p->p_rwait, &p->p_wpos, p->p_rpos);
+	}
 
-    /*Step 2: If pointer of reading is ahead of writing,then yield. */
-    
     /*Step 3: p_buf's size is BY2PIPE, and you should use it to fill rbuf. */
+	for (i = 0; i < n && p->p_rpos != p->p_wpos; i++) {
+		rbuf[i] = p->p_buf[p->p_rpos % BY2PIPE];
+		pipe_fence();
+		p->p_rpos++;
+	}
+	pipe_wake(&p->p_wwait, &p->p_rpos);
 	return i;
 }
 
@@ -156,14 +205,30 @@ static int
 pipewrite(struct Fd *fd, const void *vbuf, u_int n, u_int offset)
 {
 	int i;
+	u_int seen;
 	struct Pipe *p;
 	char *wbuf;
 
     /*Step 1: Get the pipe p according to fd. And vbuf is the writing buffer. */
-
-    /*Step 2: If the difference between the pointer of writing and reading is larger than BY2PIPE, then yield. */
+	p = (struct Pipe *)fd2data(fd);
+	wbuf = (char *)vbuf;
+
+	for (i = 0; i < n; i++) {
+    /*Step 2: If the difference between the pointer of writing and reading is larger than BY2PIPE, then wait. */
+		while (p->p_wpos - (seen = p->p_rpos) >= BY2PIPE) {
+			if (_pipeisclosed(fd, p)) {
+				return 0;
+			}
+			pipe_wake(&p->p_rwait, &p->p_wpos);
+			pipe_wait(&p->p_wwait, &p->p_rpos, seen);
+		}
 
     /*Step 3: p_buf's size is BY2PIPE, and you should use it to fill rbuf. */
+		p->p_buf[p->p_wpos % BY2PIPE] = wbuf[i];
+		pipe_fence();
+		p->p_wpos++;
+	}
+	pipe_wake(&p->p_rwait, &p->p_wpos);
 	return n;
 }
 
@@ -0,0 +1,24 @@
+// Server of the priority inheritance benchmark (user/pibench.c). Runs
+// at the lowest weight and spends SERVER_WORK cycles on each request.
+
+#include "lib.h"
+#include <kclock.h>
+#include "pibench.h"
+
+#define SERVER_WORK	200000UL	// cycles the server spends per request
+
+void
+umain(void)
+{
+	u_int who, v;
+	u_int64_t end;
+
+	syscall_set_sched(0, SCHED_FAIR, 1);
+	for (;;) {
+		v = ipc_recv(&who, 0, 0);
+		end = get_cycle() + SERVER_WORK;
+		while (get_cycle() < end)
+			;
+		ipc_send(who, v, 0, 0);
+	}
+}
@@ -0,0 +1,25 @@
+// Fan-in client of the IPC benchmark suite (user/pingpong.c). Waits
+// for pingpong to grant it a sample page, calls ppserver PP_NREQ times
+// recording each round trip there, then reports back.
+
+#include "lib.h"
+#include <kclock.h>
+#include "pingpong.h"
+
+void
+umain(void)
+{
+	u_int64_t *s = (u_int64_t *)PP_SAMPLE_VA;
+	u_int64_t t;
+	u_int who, srv;
+	int i;
+
+	srv = envs[PP_SERVER].env_id;
+	ipc_recv(&who, PP_SAMPLE_VA, 0);
+	for (i = 0; i < PP_NREQ; i++) {
+		t = get_cycle();
+		ipc_call(srv, i, 0, 0, 0, 0);
+		s[i] = get_cycle() - t;
+	}
+	ipc_send(who, 0, 0, 0);
+}
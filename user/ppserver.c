@@ -0,0 +1,16 @@
+// Echo server of the IPC benchmark suite (user/pingpong.c): replies to
+// each call with its value plus one. rpcbench uses it too.
+
+#include "lib.h"
+#include "pingpong.h"
+
+void
+umain(void)
+{
+	u_int who, v;
+
+	v = ipc_reply_recv(0, 0, 0, 0, &who, PP_PAGE_VA, 0);
+	for (;;) {
+		v = ipc_reply_recv(who, v + 1, 0, 0, &who, PP_PAGE_VA, 0);
+	}
+}
@@ -7,8 +7,25 @@
 
 void halt(void);
 
+// Output of one writef, sent with a single syscall_console_write
+// unless it does not fit.
+struct outbuf {
+	int n;
+	char buf[256];
+};
+
+static void
+user_flush(struct outbuf *b)
+{
+	if (b->n > 0) {
+		syscall_console_write(b->buf, b->n);
+		b->n = 0;
+	}
+}
+
 static void user_myoutput(void *arg, const char *s, int l)
 {
+	struct outbuf *b = arg;
 	int i;
 
 	// special termination call
@@ -17,31 +34,36 @@ static void user_myoutput(void *arg, const char *s, int l)
 	}
 
 	for (i = 0; i < l; i++) {
-		//sbi_console_putchar(s[i]);
-
-		if (s[i] == '\n') {
-			//sbi_console_putchar('\n');
+		if (b->n == sizeof(b->buf)) {
+			user_flush(b);
 		}
+		b->buf[b->n++] = s[i];
 	}
 }
 
 void writef(char *fmt, ...)
 {
+	struct outbuf b;
 	va_list ap;
+
+	b.n = 0;
 	va_start(ap, fmt);
-	user_lp_Print(user_myoutput, 0, fmt, ap);
+	user_lp_Print(user_myoutput, &b, fmt, ap);
 	va_end(ap);
+	user_flush(&b);
 }
 
 void
 _user_panic(const char *file, int line, const char *fmt, ...)
 {
+	struct outbuf b;
 	va_list ap;
 
-
+	b.n = 0;
 	va_start(ap, fmt);
 	writef("panic at %s:%d: ", file, line);
-	user_lp_Print(user_myoutput, 0, (char *)fmt, ap);
+	user_lp_Print(user_myoutput, &b, (char *)fmt, ap);
+	user_flush(&b);
 	writef("\n");
 	va_end(ap);
 
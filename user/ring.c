@@ -0,0 +1,138 @@
+// Shared-memory single-producer/single-consumer message rings.
+// The pages are mapped PTE_LIBRARY, so a ring made before fork() is
+// shared by parent and child; an unrelated env can be given it with
+// sys_mem_map at the same va, as ringbench does. Each side blocks on its own
+// notification object and is only signalled while it says it waits,
+// so a busy ring costs no syscalls.
+
+#include "lib.h"
+#include <mmu.h>
+
+#define ring_fence()	__asm__ __volatile__("fence rw, rw" ::: "memory")
+
+// Create a ring at va: a header page and npages (a power of two) data
+// pages. Both sides must ring_attach() before blocking.
+int
+ring_create(u_int va, u_int npages)
+{
+	struct Ring *r = (struct Ring *)va;
+	int i, err;
+
+	if (npages == 0 || (npages & (npages - 1)) != 0) {
+		return -E_INVAL;
+	}
+	for (i = 0; i <= npages; i++) {
+		if ((err = syscall_mem_alloc(0, va + i * BY2PG,
+									 PTE_V | PTE_R | PTE_LIBRARY)) < 0) {
+			while (--i >= 0) {
+				syscall_mem_unmap(0, va + i * BY2PG);
+			}
+			return err;
+		}
+	}
+	r->r_head = r->r_tail = 0;
+	r->r_prod_waiting = r->r_cons_waiting = 0;
+	r->r_space = r->r_data = 0;
+	r->r_size = npages * BY2PG;
+	return 0;
+}
+
+// Take the producer or consumer side: allocate the notification
+// object this env will block on.
+int
+ring_attach(struct Ring *r, int side)
+{
+	int id;
+
+	if ((id = syscall_notif_alloc()) < 0) {
+		return id;
+	}
+	if (side == RING_PRODUCER) {
+		r->r_space = id;
+	} else {
+		r->r_data = id;
+	}
+	return 0;
+}
+
+static void
+ring_copy_in(struct Ring *r, u_int pos, const void *buf, u_int len)
+{
+	u_int off = pos & (r->r_size - 1);
+	u_int n = MIN(len, r->r_size - off);
+
+	user_bcopy(buf, ring2data(r) + off, n);
+	user_bcopy((const char *)buf + n, ring2data(r), len - n);
+}
+
+static void
+ring_copy_out(struct Ring *r, u_int pos, void *buf, u_int len)
+{
+	u_int off = pos & (r->r_size - 1);
+	u_int n = MIN(len, r->r_size - off);
+
+	user_bcopy(ring2data(r) + off, buf, n);
+	user_bcopy(ring2data(r), (char *)buf + n, len - n);
+}
+
+// Append a message of len bytes, blocking while the ring is too full.
+int
+ring_send(struct Ring *r, const void *buf, u_int len)
+{
+	u_int need = sizeof(u_int) + ROUND(len, sizeof(u_int));
+
+	if (need > r->r_size) {
+		return -E_INVAL;
+	}
+	while (r->r_size - (r->r_head - r->r_tail) < need) {
+		r->r_prod_waiting = 1;
+		ring_fence();
+		// recheck: the consumer may have made room before seeing the flag
+		if (r->r_size - (r->r_head - r->r_tail) < need) {
+			notif_wait(r->r_space);
+		}
+		r->r_prod_waiting = 0;
+	}
+
+	ring_copy_in(r, r->r_head, &len, sizeof(u_int));
+	ring_copy_in(r, r->r_head + sizeof(u_int), buf, len);
+	ring_fence();
+	r->r_head += need;
+	ring_fence();
+	if (r->r_cons_waiting) {
+		syscall_notif_signal(r->r_data, 1);
+	}
+	return 0;
+}
+
+// Take the next message into buf, blocking while the ring is empty.
+// Returns its length, or -E_INVAL (leaving it queued) if it is longer
+// than max.
+int
+ring_recv(struct Ring *r, void *buf, u_int max)
+{
+	u_int len;
+
+	while (r->r_head == r->r_tail) {
+		r->r_cons_waiting = 1;
+		ring_fence();
+		if (r->r_head == r->r_tail) {
+			notif_wait(r->r_data);
+		}
+		r->r_cons_waiting = 0;
+	}
+	ring_fence();
+
+	ring_copy_out(r, r->r_tail, &len, sizeof(u_int));
+	if (len > max) {
+		return -E_INVAL;
+	}
+	ring_copy_out(r, r->r_tail + sizeof(u_int), buf, len);
+	ring_fence();
+	r->r_tail += sizeof(u_int) + ROUND(len, sizeof(u_int));
+	ring_fence();
+	if (r->r_prod_waiting) {
+		syscall_notif_signal(r->r_space, 1);
+	}
+	return len;
+}
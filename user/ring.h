@@ -0,0 +1,32 @@
+#ifndef _USER_RING_H_
+#define _USER_RING_H_ 1
+
+#include <types.h>
+
+#define RING_LINE	64	// keep producer and consumer fields apart
+
+#define RING_PRODUCER	0
+#define RING_CONSUMER	1
+
+// Header page of a single-producer/single-consumer ring of messages.
+// The data pages follow it; each message is a u_int length and the
+// payload, padded to 4 bytes. Indices count bytes ever written/read.
+struct Ring {
+	// written only by the producer
+	volatile u_int r_head;
+	volatile u_int r_prod_waiting;	// producer is blocked on r_space
+	u_int r_space;			// producer's notif, signalled on consume
+	u_char r_pad0[RING_LINE - 12];
+
+	// written only by the consumer
+	volatile u_int r_tail;
+	volatile u_int r_cons_waiting;	// consumer is blocked on r_data
+	u_int r_data;			// consumer's notif, signalled on produce
+	u_char r_pad1[RING_LINE - 12];
+
+	u_int r_size;			// bytes of data, a power of two
+};
+
+#define ring2data(r)	((u_char *)(r) + BY2PG)
+
+#endif
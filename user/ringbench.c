@@ -0,0 +1,130 @@
+// Bulk-transfer benchmark: a shared-memory ring against a pipe,
+// against page-grant IPC one page at a time, and against a single
+// multi-page grant. ringprod streams RB_TOTAL bytes in RB_MSG byte
+// messages; ringbench receives them and prints the cycles taken.
+// ringprod is started by the kernel in slot RB_PROD; the ring and the
+// pipe's write end are shared with it by sys_mem_map, as they are
+// PTE_LIBRARY pages.
+
+#include "lib.h"
+#include <kclock.h>
+#include "ringbench.h"
+
+static char buf[BY2PG];
+
+static void
+report(char *kind, u_int msg, u_int64_t cycles)
+{
+	writef("ringbench: kind=%s bytes=%d msg=%d cycles=%ld bytes_per_kcycle=%ld\n",
+		   kind, RB_TOTAL, msg, (long)cycles,
+		   (long)((u_int64_t)RB_TOTAL * 1000 / (cycles ? cycles : 1)));
+}
+
+// Map npages at va into the producer at the same address.
+static void
+share(u_int prod, u_int va, u_int npages)
+{
+	u_int i;
+	int r;
+
+	for (i = 0; i < npages; i++) {
+		if ((r = syscall_mem_map(0, va + i * BY2PG, prod, va + i * BY2PG,
+								 PTE_V | PTE_R | PTE_LIBRARY)) < 0) {
+			user_panic("ringbench: mem_map %x: %d", va + i * BY2PG, r);
+		}
+	}
+}
+
+static void
+bench_ring(u_int prod)
+{
+	struct Ring *r = (struct Ring *)RB_RING_VA;
+	u_int64_t start;
+	u_int n;
+	int got;
+
+	if (ring_create(RB_RING_VA, RB_RING_PAGES) < 0 ||
+		ring_attach(r, RING_CONSUMER) < 0) {
+		user_panic("ringbench: ring setup failed");
+	}
+	share(prod, RB_RING_VA, 1 + RB_RING_PAGES);
+	ipc_send(prod, RB_GO(RB_RING, 0), 0, 0);
+
+	start = get_cycle();
+	for (n = 0; n < RB_TOTAL; n += got) {
+		if ((got = ring_recv(r, buf, sizeof(buf))) <= 0) {
+			user_panic("ringbench: ring_recv: %d", got);
+		}
+	}
+	report("ring", RB_MSG, get_cycle() - start);
+}
+
+static void
+bench_pipe(u_int prod)
+{
+	struct Fd *fd;
+	u_int64_t start;
+	u_int n;
+	int p[2], got;
+
+	if (pipe(p) < 0 || fd_lookup(p[1], &fd) < 0) {
+		user_panic("ringbench: pipe failed");
+	}
+	// hand over the write end: its fd page and the pipe page behind it
+	share(prod, (u_int)fd, 1);
+	share(prod, fd2data(fd), 1);
+	close(p[1]);
+	ipc_send(prod, RB_GO(RB_PIPE, p[1]), 0, 0);
+
+	start = get_cycle();
+	for (n = 0; n < RB_TOTAL; n += got) {
+		if ((got = read(p[0], buf, RB_MSG)) <= 0) {
+			user_panic("ringbench: pipe read: %d", got);
+		}
+	}
+	report("pipe", RB_MSG, get_cycle() - start);
+	close(p[0]);
+}
+
+static void
+bench_page(u_int prod)
+{
+	u_int64_t start;
+	u_int n, who;
+
+	ipc_send(prod, RB_GO(RB_PAGE, 0), 0, 0);
+
+	start = get_cycle();
+	for (n = 0; n < RB_TOTAL; n += BY2PG) {
+		ipc_recv(&who, RB_PAGE_VA, 0);
+	}
+	report("page", BY2PG, get_cycle() - start);
+}
+
+static void
+bench_grant(u_int prod)
+{
+	u_int64_t start;
+	u_int who;
+
+	ipc_send(prod, RB_GO(RB_GRANT, 0), 0, 0);
+
+	start = get_cycle();
+	ipc_recv_pages(&who, RB_PAGE_VA, RB_TOTAL / BY2PG, 0);
+	if (env->env_ipc_npages != RB_TOTAL / BY2PG) {
+		user_panic("ringbench: got %d pages", env->env_ipc_npages);
+	}
+	report("grant", RB_TOTAL, get_cycle() - start);
+}
+
+void
+umain(void)
+{
+	u_int prod = envs[RB_PROD].env_id;
+
+	bench_ring(prod);
+	bench_pipe(prod);
+	bench_page(prod);
+	bench_grant(prod);
+	ipc_send(prod, RB_DONE, 0, 0);
+}
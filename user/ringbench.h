@@ -0,0 +1,26 @@
+// envs[] layout and phases of the bulk-transfer benchmark. Start
+// ringbench, then ringprod right after it in slot RB_PROD; see
+// init/init.c.
+
+#ifndef _RINGBENCH_H_
+#define _RINGBENCH_H_
+
+#define RB_PROD		1		// envs[] slot of ringprod
+#define RB_TOTAL	(1 << 20)	// bytes streamed per phase
+#define RB_MSG		256		// bytes per ring or pipe message
+#define RB_RING_VA	0x50000000
+#define RB_RING_PAGES	4
+#define RB_PAGE_VA	0x48000000
+
+// ringbench starts each phase of ringprod with a message carrying the
+// phase and, for the pipe, the fd number of the write end.
+#define RB_DONE		0
+#define RB_RING		1
+#define RB_PIPE		2
+#define RB_PAGE		3
+#define RB_GRANT	4
+#define RB_GO(phase, fd)	((phase) | ((fd) << 8))
+#define RB_PHASE(v)	((v) & 0xff)
+#define RB_FD(v)	((v) >> 8)
+
+#endif
@@ -0,0 +1,61 @@
+// Producer of the bulk-transfer benchmark (user/ringbench.c). Waits for
+// ringbench to start each phase, streams RB_TOTAL bytes the way that
+// phase says, and goes back for the next until RB_DONE.
+
+#include "lib.h"
+#include "ringbench.h"
+
+static char buf[BY2PG];
+
+void
+umain(void)
+{
+	struct Ring *r = (struct Ring *)RB_RING_VA;
+	u_int who, v, n;
+	int fd;
+
+	while ((v = ipc_recv(&who, 0, 0)) != RB_DONE) {
+		switch (RB_PHASE(v)) {
+		case RB_RING:
+			// ringbench has mapped the ring pages in for us
+			if (ring_attach(r, RING_PRODUCER) < 0) {
+				user_panic("ringprod: ring_attach failed");
+			}
+			for (n = 0; n < RB_TOTAL; n += RB_MSG) {
+				ring_send(r, buf, RB_MSG);
+			}
+			break;
+
+		case RB_PIPE:
+			// and the write end of the pipe, at the same fd
+			fd = RB_FD(v);
+			for (n = 0; n < RB_TOTAL; n += RB_MSG) {
+				write(fd, buf, RB_MSG);
+			}
+			close(fd);
+			break;
+
+		// One page per message: each costs a map here and a remap
+		// into ringbench.
+		case RB_PAGE:
+			for (n = 0; n < RB_TOTAL; n += BY2PG) {
+				syscall_mem_alloc(0, RB_PAGE_VA, PTE_V | PTE_R);
+				ipc_send(who, n, RB_PAGE_VA, PTE_V | PTE_R);
+			}
+			break;
+
+		// The whole buffer in one message: one rendezvous, one TLB
+		// flush.
+		case RB_GRANT:
+			for (n = 0; n < RB_TOTAL; n += BY2PG) {
+				syscall_mem_alloc(0, RB_PAGE_VA + n, PTE_V | PTE_R);
+			}
+			ipc_send_pages(who, 0, RB_PAGE_VA, RB_TOTAL / BY2PG,
+						   PTE_V | PTE_R);
+			break;
+
+		default:
+			user_panic("ringprod: bad phase %x", v);
+		}
+	}
+}
@@ -0,0 +1,38 @@
+// RPC round-trip benchmark for ipc_call/ipc_reply_recv.
+// Compares a call/reply round trip against a bare syscall; the direct
+// switch should keep the ratio a small constant.
+// The server is ppserver, the echo server of the IPC benchmark suite:
+// start rpcbench, then ppserver right after it in slot PP_SERVER.
+
+#include "lib.h"
+#include <kclock.h>
+#include "pingpong.h"
+
+#define ROUNDS	1000
+
+void
+umain(void)
+{
+	u_int srv;
+	u_int64_t start, null_cyc, rpc_cyc;
+	int i;
+
+	srv = envs[PP_SERVER].env_id;
+
+	start = get_cycle();
+	for (i = 0; i < ROUNDS; i++) {
+		syscall_getenvid();
+	}
+	null_cyc = (get_cycle() - start) / ROUNDS;
+
+	ipc_call(srv, 0, 0, 0, 0, 0);	// warm up
+	start = get_cycle();
+	for (i = 0; i < ROUNDS; i++) {
+		ipc_call(srv, i, 0, 0, 0, 0);
+	}
+	rpc_cyc = (get_cycle() - start) / ROUNDS;
+
+	writef("rpcbench: rounds=%d null_syscall=%ld rpc_rt=%ld ratio=%ld\n",
+		   ROUNDS, (long)null_cyc, (long)rpc_cyc,
+		   (long)(null_cyc ? rpc_cyc / null_cyc : 0));
+}
@@ -0,0 +1,79 @@
+// Blocking mutexes and condition variables on futex waits.
+// Put them in PTE_LIBRARY pages to share them across envs; the kernel
+// keys waits by physical address, so each env may map them anywhere.
+
+#include "lib.h"
+
+// Mutex states: 0 free, 1 held, 2 held with (possible) waiters.
+// Uncontended lock and unlock make no syscalls.
+
+void
+mutex_init(struct Mutex *m)
+{
+	m->m_state = 0;
+}
+
+void
+mutex_lock(struct Mutex *m)
+{
+	u_int c;
+
+	if ((c = __sync_val_compare_and_swap(&m->m_state, 0, 1)) == 0) {
+		return;
+	}
+	if (c != 2) {
+		c = __atomic_exchange_n(&m->m_state, 2, __ATOMIC_ACQUIRE);
+	}
+	while (c != 0) {
+		syscall_futex_wait((u_int)&m->m_state, 2, 0);
+		c = __atomic_exchange_n(&m->m_state, 2, __ATOMIC_ACQUIRE);
+	}
+}
+
+int
+mutex_trylock(struct Mutex *m)
+{
+	return __sync_val_compare_and_swap(&m->m_state, 0, 1) == 0;
+}
+
+void
+mutex_unlock(struct Mutex *m)
+{
+	if (__atomic_exchange_n(&m->m_state, 0, __ATOMIC_RELEASE) == 2) {
+		syscall_futex_wake((u_int)&m->m_state, 1);
+	}
+}
+
+// A condition variable is a sequence number bumped on every signal; a
+// waiter sleeps only while it is unchanged, so no signal is lost
+// between unlocking the mutex and sleeping.
+
+void
+cond_init(struct Cond *c)
+{
+	c->c_seq = 0;
+}
+
+void
+cond_wait(struct Cond *c, struct Mutex *m)
+{
+	u_int seq = c->c_seq;
+
+	mutex_unlock(m);
+	syscall_futex_wait((u_int)&c->c_seq, seq, 0);
+	mutex_lock(m);
+}
+
+void
+cond_signal(struct Cond *c)
+{
+	__atomic_fetch_add(&c->c_seq, 1, __ATOMIC_RELEASE);
+	syscall_futex_wake((u_int)&c->c_seq, 1);
+}
+
+void
+cond_broadcast(struct Cond *c)
+{
+	__atomic_fetch_add(&c->c_seq, 1, __ATOMIC_RELEASE);
+	syscall_futex_wake((u_int)&c->c_seq, ~0U);
+}
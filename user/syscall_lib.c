@@ -82,14 +82,198 @@ syscall_ipc_can_send(u_int envid, u_int value, u_int srcva, u_int perm)
 	return msyscall(SYS_ipc_can_send, envid, value, srcva, perm, 0);
 }
 
+int
+syscall_ipc_send(u_int envid, u_int value, u_int srcva, u_int perm)
+{
+	return msyscall(SYS_ipc_send, envid, value, srcva, perm, 0);
+}
+
+int
+syscall_ipc_call(u_int envid, u_int value, u_int srcva, u_int perm,
+				 u_int dstva)
+{
+	return msyscall(SYS_ipc_call, envid, value, srcva, perm, dstva);
+}
+
+int
+syscall_ipc_reply_recv(u_int envid, u_int value, u_int srcva, u_int perm,
+					   u_int dstva)
+{
+	return msyscall(SYS_ipc_reply_recv, envid, value, srcva, perm, dstva);
+}
+
+// The *_mr variants also carry n words of mr[], which must have room
+// for IPC_MR_WORDS words.
+int
+syscall_ipc_send_mr(u_int envid, u_int value, u_int n, u_int64_t *mr)
+{
+	return msyscall_mr(SYS_ipc_send, envid, value, 0, 0, 0, n, mr);
+}
+
+int
+syscall_ipc_call_mr(u_int envid, u_int value, u_int n, u_int64_t *mr)
+{
+	return msyscall_mr(SYS_ipc_call, envid, value, 0, 0, 0, n, mr);
+}
+
+int
+syscall_ipc_reply_recv_mr(u_int envid, u_int value, u_int n, u_int64_t *mr,
+						  u_int dstva)
+{
+	return msyscall_mr(SYS_ipc_reply_recv, envid, value, 0, 0, dstva, n, mr);
+}
+
+int
+syscall_notif_alloc(void)
+{
+	return msyscall(SYS_notif_alloc, 0, 0, 0, 0, 0);
+}
+
+int
+syscall_notif_free(u_int id)
+{
+	return msyscall(SYS_notif_free, id, 0, 0, 0, 0);
+}
+
+int
+syscall_notif_signal(u_int id, u_int bits)
+{
+	return msyscall(SYS_notif_signal, id, bits, 0, 0, 0);
+}
+
+int
+syscall_notif_wait(u_int id, u_int recv, u_int dstva)
+{
+	return msyscall(SYS_notif_wait, id, recv, dstva, 0, 0);
+}
+
+int
+syscall_futex_wait(u_int va, u_int expected, u_int timeout)
+{
+	return msyscall(SYS_futex_wait, va, expected, timeout, 0, 0);
+}
+
+int
+syscall_futex_wake(u_int va, u_int n)
+{
+	return msyscall(SYS_futex_wake, va, n, 0, 0, 0);
+}
+
+int
+syscall_ipc_recv_pages(u_int dstva, u_int npages)
+{
+	return msyscall(SYS_ipc_recv_pages, dstva, npages, 0, 0, 0);
+}
+
+int
+syscall_ipc_send_pages(u_int envid, u_int value, u_int srcva, u_int npages,
+					   u_int perm)
+{
+	return msyscall(SYS_ipc_send_pages, envid, value, srcva, npages, perm);
+}
+
+// Grant the nseg ranges in segs[] (IPC_SEG words, room for IPC_MR_WORDS)
+// in one message; they arrive back to back at the receiver.
+int
+syscall_ipc_send_sg(u_int envid, u_int value, u_int nseg, u_int64_t *segs,
+					u_int perm)
+{
+	return msyscall_mr(SYS_ipc_send_pages, envid, value, 0, IPC_PAGES_SG,
+					   perm, nseg, segs);
+}
+
+int
+syscall_ep_alloc(void)
+{
+	return msyscall(SYS_ep_alloc, 0, 0, 0, 0, 0);
+}
+
+int
+syscall_ep_bind(u_int id, u_int envid)
+{
+	return msyscall(SYS_ep_bind, id, envid, 0, 0, 0);
+}
+
+int
+syscall_ep_call(u_int id, u_int value, u_int srcva, u_int perm, u_int dstva)
+{
+	return msyscall(SYS_ep_call, id, value, srcva, perm, dstva);
+}
+
+int
+syscall_ep_call_mr(u_int id, u_int value, u_int n, u_int64_t *mr)
+{
+	return msyscall_mr(SYS_ep_call, id, value, 0, 0, 0, n, mr);
+}
+
 void
 syscall_ipc_recv(u_int dstva)
 {
 	msyscall(SYS_ipc_recv, dstva, 0, 0, 0, 0);
 }
 
+void
+syscall_ipc_recv_from(u_int dstva, u_int server)
+{
+	msyscall(SYS_ipc_recv, dstva, server, 0, 0, 0);
+}
+
 int
 syscall_cgetc()
 {
 	return msyscall(SYS_cgetc, 0, 0, 0, 0, 0);
 }
+
+int
+syscall_set_sched(u_int envid, u_int class, u_int pri)
+{
+	return msyscall(SYS_set_sched, envid, class, pri, 0, 0);
+}
+
+int
+syscall_set_deadline(u_int envid, u_int runtime, u_int period, u_int deadline)
+{
+	return msyscall(SYS_set_deadline, envid, runtime, period, deadline, 0);
+}
+
+int
+syscall_yield_to(u_int envid)
+{
+	return msyscall(SYS_yield_to, envid, 0, 0, 0, 0);
+}
+
+int
+syscall_set_affinity(u_int envid, u_int hartmask)
+{
+	return msyscall(SYS_set_affinity, envid, hartmask, 0, 0, 0);
+}
+
+int
+syscall_sysring_setup(u_int va)
+{
+	return msyscall(SYS_sysring_setup, va, 0, 0, 0, 0);
+}
+
+int
+syscall_sysring_enter(u_int flags)
+{
+	return msyscall(SYS_sysring_enter, flags, 0, 0, 0, 0);
+}
+
+int
+syscall_sysstat(u_int op, u_int arg, u_int dstva)
+{
+	return msyscall(SYS_sysstat, op, arg, dstva, 0, 0);
+}
+
+int
+syscall_cons_read(void)
+{
+	return msyscall(SYS_cons_read, 0, 0, 0, 0, 0);
+}
+
+int
+syscall_console_write(const char *buf, u_int len)
+{
+	return msyscall(SYS_console_write, (u_int)buf, len, 0, 0, 0);
+}
@@ -0,0 +1,73 @@
+// Batched syscalls: queue calls on a page shared with the kernel and
+// run them all with one syscall_sysring_enter(). See include/sysring.h
+// for the layout and lib/syscall_all.c for the calls it accepts.
+
+#include "lib.h"
+#include <mmu.h>
+
+#define sysring_fence()	__asm__ __volatile__("fence rw, rw" ::: "memory")
+
+// Allocate the page at sr and make it this env's ring.
+int
+sysring_open(struct Sysring *sr)
+{
+	int r;
+
+	if ((r = syscall_mem_alloc(0, (u_int)sr, PTE_V | PTE_R)) < 0) {
+		return r;
+	}
+	user_bzero(sr, BY2PG);
+	if ((r = syscall_sysring_setup((u_int)sr)) < 0) {
+		syscall_mem_unmap(0, (u_int)sr);
+	}
+	return r;
+}
+
+// Queue one call; nothing runs until sysring_enter(). `data` comes
+// back in its completion. Returns -E_NO_MEM when the queue is full.
+int
+sysring_prep(struct Sysring *sr, u_int64_t data, u_int sysno,
+			 u_int a0, u_int a1, u_int a2, u_int a3, u_int a4)
+{
+	struct Sysring_sqe *sqe;
+	u_int tail = sr->sr_sq_tail;
+
+	if (tail - sr->sr_sq_head >= SYSRING_ENTRIES) {
+		return -E_NO_MEM;
+	}
+	sqe = &sr->sr_sq[tail & SYSRING_MASK];
+	sqe->sq_sysno = sysno;
+	sqe->sq_args[0] = a0;
+	sqe->sq_args[1] = a1;
+	sqe->sq_args[2] = a2;
+	sqe->sq_args[3] = a3;
+	sqe->sq_args[4] = a4;
+	sqe->sq_data = data;
+	sysring_fence();
+	sr->sr_sq_tail = tail + 1;
+	return 0;
+}
+
+// Run the queued calls. Returns how many ran; sr_errors and
+// sr_first_error tell whether any of them failed.
+int
+sysring_enter(struct Sysring *sr, u_int flags)
+{
+	USED(sr);
+	return syscall_sysring_enter(flags);
+}
+
+// Take the oldest completion into *cqe. Returns 0 if there was none.
+int
+sysring_reap(struct Sysring *sr, struct Sysring_cqe *cqe)
+{
+	u_int head = sr->sr_cq_head;
+
+	if (head == sr->sr_cq_tail) {
+		return 0;
+	}
+	sysring_fence();
+	*cqe = sr->sr_cq[head & SYSRING_MASK];
+	sr->sr_cq_head = head + 1;
+	return 1;
+}
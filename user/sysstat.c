@@ -0,0 +1,48 @@
+// Syscall profile command: count every syscall for PERIOD, then print
+// the kernel's table on the console and the hottest calls by total
+// cycles. Start it next to the workload to look at.
+
+#include "lib.h"
+#include <kclock.h>
+
+#define PERIOD	(2 * TIMEBASE_HZ)	// `time` ticks to count for
+#define TOP		5
+
+static struct Sysstat st[__NR_SYSCALLS];
+
+void
+umain(void)
+{
+	u_int64_t end;
+	int i, j, best;
+	int used[__NR_SYSCALLS];
+
+	syscall_sysstat(SYSSTAT_RESET, 0, 0);
+	syscall_sysstat(SYSSTAT_ENABLE, 1, 0);
+	end = get_time() + PERIOD;
+	while (get_time() < end) {
+		syscall_yield();
+	}
+	syscall_sysstat(SYSSTAT_ENABLE, 0, 0);
+	syscall_sysstat(SYSSTAT_DUMP, 0, 0);
+
+	for (i = 0; i < __NR_SYSCALLS; i++) {
+		syscall_sysstat(SYSSTAT_GET, i, (u_int)&st[i]);
+		used[i] = 0;
+	}
+	for (j = 0; j < TOP; j++) {
+		best = -1;
+		for (i = 0; i < __NR_SYSCALLS; i++) {
+			if (!used[i] && st[i].st_calls != 0 &&
+				(best < 0 || st[i].st_cycles > st[best].st_cycles)) {
+				best = i;
+			}
+		}
+		if (best < 0) {
+			break;
+		}
+		used[best] = 1;
+		writef("sysstat: rank=%d sys=%d calls=%ld cycles=%ld\n", j + 1,
+			   best, (long)st[best].st_calls, (long)st[best].st_cycles);
+	}
+}